@@ -0,0 +1,3 @@
+var addon = require('bindings')('deephedge');
+
+addon.JsRunNumericConversionsBenchmark(1000000);
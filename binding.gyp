@@ -7,6 +7,7 @@
                 "<!(node -p \"require('node-addon-api').targets\"):node_addon_api_except_all",
             ],
             "include_dirs": ["src/trading/strategies/stop-loss-arb/cpp/include"],
+            "defines": ["FIXED_PRICE_DECIMALS=6"],
             "msvs_settings": {
                 "VCCLCompilerTool": {
                     "AdditionalOptions": [
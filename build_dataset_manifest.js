@@ -0,0 +1,5 @@
+var addon = require('bindings')('deephedge');
+
+// Optional argument: dataset root folder, defaults to ../deephedge/historical-data-80
+var numRead = addon.JsUpdateDatasetManifest(...process.argv.slice(2));
+console.log(`Updated dataset manifest, read ${numRead} new or changed snapshot files`);
@@ -0,0 +1,16 @@
+var addon = require('bindings')('deephedge');
+
+// Arguments: folder of raw quote dumps (<TICKER>/<YYYY-MM-DD>.csv), optionally the
+// snapshots root to write into, defaults to ../deephedge/historical-data-80, and
+// --compressed to write delta/varint coded files instead of raw columns
+var args = process.argv.slice(2);
+var isCompressed = args.includes('--compressed');
+var [rawRoot, snapshotRoot] = args.filter((arg) => arg !== '--compressed');
+
+if (!rawRoot) {
+    console.error('Usage: node convert_raw_quotes_to_snapshots.js <raw quotes folder> [snapshots folder] [--compressed]');
+    process.exit(1);
+}
+
+var numConverted = addon.JsConvertRawQuoteFilesToSnapshots(rawRoot, snapshotRoot, isCompressed);
+console.log(`Converted ${numConverted} raw quote files to snapshots`);
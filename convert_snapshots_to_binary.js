@@ -0,0 +1,10 @@
+var addon = require('bindings')('deephedge');
+
+// Optional arguments: root folder to convert, defaults to ../deephedge/historical-data-80,
+// and --compressed to write delta/varint coded files instead of raw columns
+var args = process.argv.slice(2);
+var isCompressed = args.includes('--compressed');
+var root = args.find((arg) => arg !== '--compressed');
+
+var numConverted = addon.JsConvertSnapshotJsonFilesToBinary(root, isCompressed);
+console.log(`Converted ${numConverted} snapshot files to binary`);
@@ -1,7 +1,5 @@
 #include "utils.hpp"
 
-#include <sstream>
-
 using namespace std;
 
 void Print(variant<std::wstring, std::string> message)
@@ -16,16 +14,6 @@ void Print(variant<std::wstring, std::string> message)
     }
 };
 
-std::string DoubleToStr(const double& value)
-{
-    std::ostringstream oss{};
-    oss.precision(kDecimalPrecision);
-    oss << value;
-    return oss.str();
-}
-
-Decimal GetDecimal(const double& value) { return Decimal{DoubleToStr(value)}; }
-
 std::vector<std::string> string_split(const std::string& str, const char& delimiter)
 {
     vector<string> result{};
@@ -54,3 +42,13 @@ std::vector<std::string> string_split(const std::string& str, const char& delimi
 
     return result;
 }
+
+void HashInteger(uint64_t& hash, int64_t value)
+{
+    const uint64_t kFnvPrime = 1099511628211ull;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        hash = (hash ^ ((static_cast<uint64_t>(value) >> (i * 8)) & 0xff)) * kFnvPrime;
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <boost/multiprecision/cpp_dec_float.hpp>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <variant>
@@ -12,6 +13,10 @@ const int kDecimalPrecision = 12;
 using Decimal = boost::multiprecision::number<
     boost::multiprecision::backends::cpp_dec_float<kDecimalPrecision>>;
 
-Decimal GetDecimal(const double& value);
-
 std::vector<std::string> string_split(const std::string& str, const char& delimiter);
+
+// 64-bit FNV-1a. Start from kFnvOffsetBasis and feed values with HashInteger.
+const uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+
+// Mixes the 8 bytes of `value` into `hash`, least significant first.
+void HashInteger(uint64_t& hash, int64_t value);
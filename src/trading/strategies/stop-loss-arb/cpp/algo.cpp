@@ -1,13 +1,21 @@
 
 #include "algo.hpp"
 
+#include <format>
+#include <optional>
 #include <vector>
 
+#include "interval_ladder.hpp"
 #include "price_simulator.hpp"
 #include "types.hpp"
 
 using namespace std;
 
+const FixedPrice ONE_PERCENTAGE = FixedPrice::FromDouble(1.0);
+const FixedPrice ZERO_POINT_75_PERCENTAGE = FixedPrice::FromDouble(0.75);
+const FixedPrice ZERO_POINT_5_PERCENTAGE = FixedPrice::FromDouble(0.5);
+const FixedPrice ZERO_POINT_25_PERCENTAGE = FixedPrice::FromDouble(0.25);
+
 Snapshot ReconcileStockPosition(const std::string& stock, StockState& stockState)
 {
     // 0)
@@ -15,9 +23,37 @@ Snapshot ReconcileStockPosition(const std::string& stock, StockState& stockState
     // stockState.brokerageId) : GetSimulatedSnapshot(stock);
     Snapshot snapshot = GetSimulatedSnapshot(stockState);
 
+    ReconcileStockPositionOnSnapshot(stock, stockState, snapshot);
+
+    return snapshot;
+}
+
+void ReconcileStockPositionOnSnapshot(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+)
+{
+    if (stockState.isStaticIntervals)
+    {
+        ReconcileStockPositionOnSnapshotFor<true, kDynamicNumWords>(
+            stock, stockState, snapshot
+        );
+    }
+    else
+    {
+        ReconcileStockPositionOnSnapshotFor<false, kDynamicNumWords>(
+            stock, stockState, snapshot
+        );
+    }
+}
+
+template <bool kIsStaticIntervals, int kNumWords>
+void ReconcileStockPositionOnSnapshotFor(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+)
+{
     if (IsWideBidAskSpread(snapshot, stockState) || !snapshot.bid || !snapshot.ask)
     {
-        return snapshot;
+        return;
     }
 
     const bool isSnapshotChanged = IsSnapshotChange(snapshot, stockState);
@@ -43,15 +79,15 @@ Snapshot ReconcileStockPosition(const std::string& stock, StockState& stockState
     // }
 
     // 2)
-    vector<int> intervalIndicesToExecute = GetNumToBuy(stockState, snapshot);
-    const int numToBuy = intervalIndicesToExecute.size();
+    const int numToBuy =
+        GetNumToBuyFor<kIsStaticIntervals, kNumWords>(stockState, snapshot);
 
     // 3)
     int numToSell = 0;
     if (numToBuy == 0)
     {
-        intervalIndicesToExecute = GetNumToSell(stockState, snapshot);
-        numToSell = intervalIndicesToExecute.size();
+        numToSell =
+            GetNumToSellFor<kIsStaticIntervals, kNumWords>(stockState, snapshot);
     }
 
     // 4)
@@ -73,8 +109,10 @@ Snapshot ReconcileStockPosition(const std::string& stock, StockState& stockState
         SetNewPosition(stock, stockState, newPosition.value(), snapshot, orderSide);
 
         // TODO: refactor so price is returned from setNewPosition
-        Decimal priceSetAt = orderSide == "BUY" ? snapshot.ask : snapshot.bid;
-        UpdateRealizedPnL(stockState, intervalIndicesToExecute, orderSide, priceSetAt);
+        FixedPrice priceSetAt = orderSide == "BUY" ? snapshot.ask : snapshot.bid;
+        UpdateRealizedPnL(
+            stockState, stockState.intervals.toExecute, orderSide, priceSetAt
+        );
 
         CheckCrossings(stockState, snapshot);
     }
@@ -93,10 +131,21 @@ Snapshot ReconcileStockPosition(const std::string& stock, StockState& stockState
         //     );
         // }
     }
-
-    return snapshot;
 }
 
+template void ReconcileStockPositionOnSnapshotFor<false, kDynamicNumWords>(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+);
+template void ReconcileStockPositionOnSnapshotFor<true, kDynamicNumWords>(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+);
+template void ReconcileStockPositionOnSnapshotFor<false, 1>(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+);
+template void ReconcileStockPositionOnSnapshotFor<true, 1>(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+);
+
 bool IsWideBidAskSpread(const Snapshot& snapshot, const StockState& stockState)
 {
     return (snapshot.ask - snapshot.bid) >= stockState.spaceBetweenIntervals;
@@ -104,127 +153,132 @@ bool IsWideBidAskSpread(const Snapshot& snapshot, const StockState& stockState)
 
 bool CheckCrossings(StockState& stockState, const Snapshot& snapshot)
 {
-    auto& intervals = stockState.intervals;
+    return MarkLadderCrossings(stockState.intervals, snapshot.ask, snapshot.bid);
+}
 
-    bool crossingHappened = false;
-    for (auto& interval : intervals)
+int GetNumToBuy(StockState& stockState, const Snapshot& snapshot)
+{
+    if (stockState.isStaticIntervals)
     {
-        if (interval.BUY.active && !interval.BUY.crossed &&
-            snapshot.ask < interval.BUY.price)
-        {
-            interval.BUY.crossed = true;
-            crossingHappened = true;
-        }
-
-        if (interval.SELL.active && !interval.SELL.crossed &&
-            snapshot.bid > interval.SELL.price)
-        {
-            interval.SELL.crossed = true;
-            crossingHappened = true;
-        }
+        return GetNumToBuyFor<true, kDynamicNumWords>(stockState, snapshot);
     }
 
-    return crossingHappened;
+    return GetNumToBuyFor<false, kDynamicNumWords>(stockState, snapshot);
 }
 
-std::vector<int> GetNumToBuy(StockState& stockState, const Snapshot& snapshot)
+template <bool kIsStaticIntervals, int kNumWords>
+int GetNumToBuyFor(StockState& stockState, const Snapshot& snapshot)
 {
     auto& intervals = stockState.intervals;
+    auto& toExecute = intervals.toExecute;
     int position = stockState.position;
 
     int newPosition = position;
-    vector<int> indicesToExecute;
 
-    for (int i = intervals.size() - 1; i >= 0; --i)
-    {
-        const auto& interval = intervals[i];
+    GetExecutableBuyIntervals(intervals, snapshot.ask, toExecute);
 
-        if (snapshot.ask >= interval.BUY.price && interval.BUY.active &&
-            interval.BUY.crossed)
+    // Bottom-up, so the lowest intervals are filled first.
+    toExecute.ForEachReverse<kNumWords>(
+        [&](int i)
         {
-            if (newPosition < interval.positionLimit)
+            if (newPosition < intervals.positionLimits[i])
             {
-                indicesToExecute.insert(indicesToExecute.begin(), i);
                 newPosition += stockState.sharesPerInterval;
             }
+            else
+            {
+                toExecute.Reset(i);
+            }
         }
-    }
+    );
 
-    for (const int index : indicesToExecute)
+    toExecute.ForEach<kNumWords>([&](int i) { RemoveOpenPosition(stockState, i); });
+    for (int w = 0; w < toExecute.GetWordCount<kNumWords>(); ++w)
     {
-        auto& interval = intervals[index];
-
-        interval.BUY.active = false;
-        interval.BUY.crossed = false;
-
-        interval.SELL.active = true;
-        interval.SELL.crossed = false;
+        const uint64_t executed = toExecute.words[w];
+        intervals.buyActive.words[w] &= ~executed;
+        intervals.buyCrossed.words[w] &= ~executed;
+        intervals.sellActive.words[w] |= executed;
+        intervals.sellCrossed.words[w] &= ~executed;
     }
+    toExecute.ForEach<kNumWords>([&](int i) { AddOpenPosition(stockState, i); });
 
-    if (stockState.isStaticIntervals)
+    if constexpr (kIsStaticIntervals)
     {
-        AddSkippedBuysIfRequired(stockState, indicesToExecute);
+        AddSkippedBuysIfRequired(stockState, toExecute);
     }
 
-    if (!indicesToExecute.empty())
+    if constexpr (!kIsStaticIntervals)
     {
-        if (!stockState.isStaticIntervals)
+        if (toExecute.Any<kNumWords>())
         {
-            CorrectBadBuyIfRequired(stockState, indicesToExecute);
+            CorrectBadBuyIfRequired(stockState, toExecute);
         }
     }
 
-    return indicesToExecute;
+    return toExecute.Count<kNumWords>();
 }
 
-std::vector<int> GetNumToSell(StockState& stockState, const Snapshot& snapshot)
+int GetNumToSell(StockState& stockState, const Snapshot& snapshot)
+{
+    if (stockState.isStaticIntervals)
+    {
+        return GetNumToSellFor<true, kDynamicNumWords>(stockState, snapshot);
+    }
+
+    return GetNumToSellFor<false, kDynamicNumWords>(stockState, snapshot);
+}
+
+template <bool kIsStaticIntervals, int kNumWords>
+int GetNumToSellFor(StockState& stockState, const Snapshot& snapshot)
 {
     auto& intervals = stockState.intervals;
+    auto& toExecute = intervals.toExecute;
     int position = stockState.position;
 
     int newPosition = position;
-    vector<int> indicesToExecute;
 
-    for (int i = 0; i < intervals.size(); ++i)
-    {
-        const auto& interval = intervals[i];
+    GetExecutableSellIntervals(intervals, snapshot.bid, toExecute);
 
-        if (snapshot.bid <= interval.SELL.price && interval.SELL.active &&
-            interval.SELL.crossed)
+    toExecute.ForEach<kNumWords>(
+        [&](int i)
         {
-            if (newPosition > interval.positionLimit)
+            if (newPosition > intervals.positionLimits[i])
             {
-                indicesToExecute.push_back(i);
                 newPosition -= stockState.sharesPerInterval;
             }
+            else
+            {
+                toExecute.Reset(i);
+            }
         }
-    }
+    );
 
-    if (stockState.isStaticIntervals)
+    if constexpr (kIsStaticIntervals)
     {
-        AddSkippedSellsIfRequired(stockState, indicesToExecute);
+        AddSkippedSellsIfRequired(stockState, toExecute);
     }
 
-    for (const int index : indicesToExecute)
+    toExecute.ForEach<kNumWords>([&](int i) { RemoveOpenPosition(stockState, i); });
+    for (int w = 0; w < toExecute.GetWordCount<kNumWords>(); ++w)
     {
-        auto& interval = intervals[index];
-
-        interval.SELL.active = false;
-        interval.SELL.crossed = false;
-
-        interval.BUY.active = true;
-        interval.BUY.crossed = false;
+        const uint64_t executed = toExecute.words[w];
+        intervals.sellActive.words[w] &= ~executed;
+        intervals.sellCrossed.words[w] &= ~executed;
+        intervals.buyActive.words[w] |= executed;
+        intervals.buyCrossed.words[w] &= ~executed;
     }
+    toExecute.ForEach<kNumWords>([&](int i) { AddOpenPosition(stockState, i); });
 
-    if (!indicesToExecute.empty())
+    if constexpr (!kIsStaticIntervals)
     {
-        if (!stockState.isStaticIntervals)
+        if (toExecute.Any<kNumWords>())
         {
-            CorrectBadSellIfRequired(stockState, indicesToExecute);
+            CorrectBadSellIfRequired(stockState, toExecute);
         }
     }
 
-    return indicesToExecute;
+    return toExecute.Count<kNumWords>();
 }
 
 bool IsSnapshotChange(const Snapshot& snapshot, const StockState& stockState)
@@ -278,101 +332,168 @@ void SetNewPosition(
 
 void UpdateRealizedPnL(
     StockState& stockState,
-    const std::vector<int>& executedIndices,
+    const IntervalMask& executedIntervals,
     const std::string& orderSide,
-    Decimal price
+    FixedPrice price
 )
 {
-    if (executedIndices.empty())
+    const int numExecuted = executedIntervals.Count();
+    if (numExecuted == 0)
     {
         return;
     }
 
-    Decimal commissionCosts =
-        GetDecimal(executedIndices.size() * stockState.sharesPerInterval) *
-        stockState.brokerageTradingCostPerShare;
+    const int sharesExecuted = numExecuted * stockState.sharesPerInterval;
+    FixedPrice commissionCosts =
+        stockState.brokerageTradingCostPerShare * sharesExecuted;
 
     stockState.realizedPnL -= commissionCosts;
 
-    for (const int index : executedIndices)
-    {
-        auto& interval = stockState.intervals[index];
-
-        optional<Decimal> pnLFromThisExecution;
+    auto& intervals = stockState.intervals;
 
-        if (interval.type == IntervalType::LONG)
+    executedIntervals.ForEach(
+        [&](int index)
         {
-            if (orderSide == "BUY")
-            {
-                interval.SELL.boughtAtPrice = price;
-            }
-            else if (orderSide == "SELL")
+            optional<FixedPrice> pnLFromThisExecution;
+
+            if (intervals.types[index] == IntervalType::LONG)
             {
-                pnLFromThisExecution = GetDecimal(stockState.sharesPerInterval) *
-                                       (price - interval.SELL.boughtAtPrice.value());
+                if (orderSide == "BUY")
+                {
+                    RemoveOpenPosition(stockState, index);
+                    intervals.boughtAtPrices[index] = price;
+                    AddOpenPosition(stockState, index);
+                }
+                else if (orderSide == "SELL")
+                {
+                    const auto& boughtAtPrice = intervals.boughtAtPrices[index].value();
+                    pnLFromThisExecution =
+                        (price - boughtAtPrice) * stockState.sharesPerInterval;
+                }
             }
-        }
 
-        if (interval.type == IntervalType::SHORT)
-        {
-            if (orderSide == "SELL")
+            if (intervals.types[index] == IntervalType::SHORT)
             {
-                interval.BUY.soldAtPrice = price;
+                if (orderSide == "SELL")
+                {
+                    RemoveOpenPosition(stockState, index);
+                    intervals.soldAtPrices[index] = price;
+                    AddOpenPosition(stockState, index);
+                }
+                else if (orderSide == "BUY")
+                {
+                    const auto& soldAtPrice = intervals.soldAtPrices[index].value();
+                    pnLFromThisExecution =
+                        (soldAtPrice - price) * stockState.sharesPerInterval;
+                }
             }
-            else if (orderSide == "BUY")
+
+            if (pnLFromThisExecution.has_value())
             {
-                pnLFromThisExecution = GetDecimal(stockState.sharesPerInterval) *
-                                       (interval.BUY.soldAtPrice.value() - price);
+                stockState.realizedPnL += pnLFromThisExecution.value();
             }
         }
+    );
+}
+
+void UpdateSnaphotOnState(StockState& stockState, const Snapshot& snapshot)
+{
+    stockState.lastAsk = snapshot.ask;
+    stockState.lastBid = snapshot.bid;
+}
+
+bool IsExitPnLCheck()
+{
+    static const bool isExitPnLCheck = IsTruthyEnv("EXIT_PNL_CHECK");
+    return isExitPnLCheck;
+}
+
+void AccumulateOpenPosition(StockState& stockState, int index, int sign)
+{
+    const auto& intervals = stockState.intervals;
+    auto& totals = stockState.openPositionTotals;
+
+    const IntervalType type = intervals.types[index];
+    if (type == IntervalType::LONG && intervals.sellActive.Test(index))
+    {
+        totals.numLongs += sign;
+
+        const auto& boughtAtPrice = intervals.boughtAtPrices[index];
+        if (boughtAtPrice.has_value())
+        {
+            totals.boughtAtPriceSum += boughtAtPrice.value() * sign;
+        }
+        else
+        {
+            totals.numWithoutPrice += sign;
+        }
+    }
 
-        if (pnLFromThisExecution.has_value())
+    if (type == IntervalType::SHORT && intervals.buyActive.Test(index))
+    {
+        totals.numShorts += sign;
+
+        const auto& soldAtPrice = intervals.soldAtPrices[index];
+        if (soldAtPrice.has_value())
+        {
+            totals.soldAtPriceSum += soldAtPrice.value() * sign;
+        }
+        else
         {
-            stockState.realizedPnL += pnLFromThisExecution.value();
+            totals.numWithoutPrice += sign;
         }
     }
 }
 
-void UpdateSnaphotOnState(StockState& stockState, const Snapshot& snapshot)
+void AddOpenPosition(StockState& stockState, int index)
 {
-    stockState.lastAsk = snapshot.ask;
-    stockState.lastBid = snapshot.bid;
+    AccumulateOpenPosition(stockState, index, 1);
 }
 
-void UpdateExitPnL(StockState& stockState)
+void RemoveOpenPosition(StockState& stockState, int index)
 {
-    const auto& lastAsk = stockState.lastAsk;
-    const auto& lastBid = stockState.lastBid;
-    const int position = stockState.position;
+    AccumulateOpenPosition(stockState, index, -1);
+}
 
-    if (position == 0)
+void InitializeOpenPositionTotals(StockState& stockState)
+{
+    stockState.openPositionTotals = OpenPositionTotals{};
+    stockState.openPositionTotals.initialized = true;
+
+    for (int i = 0; i < stockState.intervals.size(); ++i)
     {
-        return;
+        AddOpenPosition(stockState, i);
     }
+}
+
+FixedPrice GetExitPnLByFullScan(const StockState& stockState)
+{
+    const auto& lastAsk = stockState.lastAsk;
+    const auto& lastBid = stockState.lastBid;
 
-    Decimal exitPnL = stockState.realizedPnL;
+    FixedPrice exitPnL = stockState.realizedPnL;
 
-    Decimal commissionCosts =
-        GetDecimal(position) * stockState.brokerageTradingCostPerShare;
+    FixedPrice commissionCosts =
+        stockState.brokerageTradingCostPerShare * stockState.position;
 
     exitPnL -= commissionCosts;
 
-    for (const auto& interval : stockState.intervals)
+    const auto& intervals = stockState.intervals;
+    for (int i = 0; i < intervals.size(); ++i)
     {
-        std::optional<Decimal> intervalPnL;
+        std::optional<FixedPrice> intervalPnL;
 
-        if (interval.type == IntervalType::LONG && interval.SELL.active)
+        const IntervalType type = intervals.types[i];
+        if (type == IntervalType::LONG && intervals.sellActive.Test(i))
         {
-            const auto& boughtAtPrice = interval.SELL.boughtAtPrice.value();
-            intervalPnL =
-                GetDecimal(stockState.sharesPerInterval) * (lastBid - boughtAtPrice);
+            const auto& boughtAtPrice = intervals.boughtAtPrices[i].value();
+            intervalPnL = (lastBid - boughtAtPrice) * stockState.sharesPerInterval;
         }
 
-        if (interval.type == IntervalType::SHORT && interval.BUY.active)
+        if (type == IntervalType::SHORT && intervals.buyActive.Test(i))
         {
-            const auto& soldAtPrice = interval.BUY.soldAtPrice.value();
-            intervalPnL =
-                GetDecimal(stockState.sharesPerInterval) * (soldAtPrice - lastAsk);
+            const auto& soldAtPrice = intervals.soldAtPrices[i].value();
+            intervalPnL = (soldAtPrice - lastAsk) * stockState.sharesPerInterval;
         }
 
         if (intervalPnL.has_value())
@@ -381,13 +502,130 @@ void UpdateExitPnL(StockState& stockState)
         }
     }
 
-    stockState.exitPnL = exitPnL;
+    return exitPnL;
+}
+
+FixedPrice GetExitPnL(const StockState& stockState)
+{
+    return GetExitPnLAtQuote(stockState, stockState.lastBid, stockState.lastAsk);
+}
+
+FixedPrice GetExitPnLAtQuote(
+    const StockState& stockState, FixedPrice bid, FixedPrice ask
+)
+{
+    const auto& totals = stockState.openPositionTotals;
+
+    // The full scan reads every open interval's fill price, so keep its failure mode.
+    if (totals.numWithoutPrice > 0)
+    {
+        throw bad_optional_access{};
+    }
+
+    FixedPrice exitPnL = stockState.realizedPnL;
+
+    FixedPrice commissionCosts =
+        stockState.brokerageTradingCostPerShare * stockState.position;
+
+    exitPnL -= commissionCosts;
+
+    const FixedPrice longsPnL = bid * totals.numLongs - totals.boughtAtPriceSum;
+    const FixedPrice shortsPnL = totals.soldAtPriceSum - ask * totals.numShorts;
+
+    exitPnL += (longsPnL + shortsPnL) * stockState.sharesPerInterval;
+
+    return exitPnL;
+}
+
+FixedPrice GetPercentageDenominator(const StockState& stockState)
+{
+    return stockState.initialPrice *
+           (stockState.targetPosition + stockState.sharesPerInterval);
+}
+
+FixedPrice GetExitPnLAsPercentage(const StockState& stockState, FixedPrice exitPnL)
+{
+    const FixedPrice percentage_denominator = GetPercentageDenominator(stockState);
+
+    // A state with no price to take a percentage of (e.g. a first ask of 0) would
+    // divide by zero; it reports no percentage instead.
+    if (percentage_denominator <= FixedPrice{})
+    {
+        return FixedPrice{};
+    }
+
+    return GetPercentage(exitPnL, percentage_denominator);
+}
+
+bool IsUnreachedProfitThresholdAtOrBelow(
+    const StockState& stockState, FixedPrice exitPnLAsPercentage
+)
+{
+    return (!stockState.reached_1_percentage_profit &&
+            exitPnLAsPercentage >= ONE_PERCENTAGE) ||
+           (!stockState.reached_0_75_percentage_profit &&
+            exitPnLAsPercentage >= ZERO_POINT_75_PERCENTAGE) ||
+           (!stockState.reached_0_5_percentage_profit &&
+            exitPnLAsPercentage >= ZERO_POINT_5_PERCENTAGE) ||
+           (!stockState.reached_0_25_percentage_profit &&
+            exitPnLAsPercentage >= ZERO_POINT_25_PERCENTAGE);
+}
+
+FixedPrice GetLowestUnreachedProfitThreshold(const StockState& stockState)
+{
+    if (!stockState.reached_0_25_percentage_profit)
+    {
+        return ZERO_POINT_25_PERCENTAGE;
+    }
 
-    const auto percentage_denominator =
-        GetDecimal(stockState.targetPosition + stockState.sharesPerInterval) *
-        stockState.initialPrice;
+    if (!stockState.reached_0_5_percentage_profit)
+    {
+        return ZERO_POINT_5_PERCENTAGE;
+    }
+
+    if (!stockState.reached_0_75_percentage_profit)
+    {
+        return ZERO_POINT_75_PERCENTAGE;
+    }
+
+    if (!stockState.reached_1_percentage_profit)
+    {
+        return ONE_PERCENTAGE;
+    }
+
+    return FixedPrice::Max();
+}
+
+void UpdateExitPnL(StockState& stockState)
+{
+    if (stockState.position == 0)
+    {
+        return;
+    }
+
+    if (!stockState.openPositionTotals.initialized)
+    {
+        InitializeOpenPositionTotals(stockState);
+    }
+
+    const FixedPrice exitPnL = GetExitPnL(stockState);
+
+    if (IsExitPnLCheck())
+    {
+        const FixedPrice fullScanExitPnL = GetExitPnLByFullScan(stockState);
+        if (exitPnL != fullScanExitPnL)
+        {
+            throw exception(format(
+                "Exit PnL from open position totals ({}) differs from full scan ({})",
+                exitPnL.str(),
+                fullScanExitPnL.str()
+            ).c_str());
+        }
+    }
+
+    stockState.exitPnL = exitPnL;
 
-    Decimal exitPnLAsPercentage = (exitPnL / percentage_denominator) * 100;
+    FixedPrice exitPnLAsPercentage = GetExitPnLAsPercentage(stockState, exitPnL);
 
     stockState.exitPnLAsPercentage = exitPnLAsPercentage;
 
@@ -402,7 +640,7 @@ void UpdateExitPnL(StockState& stockState)
     }
 
     if (!stockState.reached_1_percentage_profit &&
-        exitPnLAsPercentage >= GetDecimal(1.0))
+        exitPnLAsPercentage >= ONE_PERCENTAGE)
     {
         stockState.reached_1_percentage_profit = true;
         stockState.max_loss_when_reached_1_percentage_profit =
@@ -410,7 +648,7 @@ void UpdateExitPnL(StockState& stockState)
     }
 
     if (!stockState.reached_0_75_percentage_profit &&
-        exitPnLAsPercentage >= GetDecimal(0.75))
+        exitPnLAsPercentage >= ZERO_POINT_75_PERCENTAGE)
     {
         stockState.reached_0_75_percentage_profit = true;
         stockState.max_loss_when_reached_0_75_percentage_profit =
@@ -418,7 +656,7 @@ void UpdateExitPnL(StockState& stockState)
     }
 
     if (!stockState.reached_0_5_percentage_profit &&
-        exitPnLAsPercentage >= GetDecimal(0.5))
+        exitPnLAsPercentage >= ZERO_POINT_5_PERCENTAGE)
     {
         stockState.reached_0_5_percentage_profit = true;
         stockState.max_loss_when_reached_0_5_percentage_profit =
@@ -426,7 +664,7 @@ void UpdateExitPnL(StockState& stockState)
     }
 
     if (!stockState.reached_0_25_percentage_profit &&
-        exitPnLAsPercentage >= GetDecimal(0.25))
+        exitPnLAsPercentage >= ZERO_POINT_25_PERCENTAGE)
     {
         stockState.reached_0_25_percentage_profit = true;
         stockState.max_loss_when_reached_0_25_percentage_profit =
@@ -434,114 +672,109 @@ void UpdateExitPnL(StockState& stockState)
     }
 }
 
-void CorrectBadBuyIfRequired(StockState& stockState, std::vector<int>& indexesToExecute)
+// Leaves only SELL active, with nothing crossed.
+void SetSellActive(IntervalLadder& intervals, int index)
+{
+    intervals.buyActive.Reset(index);
+    intervals.buyCrossed.Reset(index);
+    intervals.sellActive.Set(index);
+    intervals.sellCrossed.Reset(index);
+}
+
+// Leaves only BUY active, with nothing crossed.
+void SetBuyActive(IntervalLadder& intervals, int index)
+{
+    intervals.sellActive.Reset(index);
+    intervals.sellCrossed.Reset(index);
+    intervals.buyActive.Set(index);
+    intervals.buyCrossed.Reset(index);
+}
+
+void CorrectBadBuyIfRequired(StockState& stockState, const IntervalMask& toExecute)
 {
-    int lowestIndexExecuted = indexesToExecute.back();
+    int lowestIndexExecuted = toExecute.Last();
     if (lowestIndexExecuted >= stockState.intervals.size() - 1)
     {
         return;
     }
 
     auto& intervals = stockState.intervals;
-    auto& intervalBelowLowestIntervalExecuted = intervals[lowestIndexExecuted + 1];
-    if (!intervalBelowLowestIntervalExecuted.BUY.active)
+    const int intervalBelowLowestIntervalExecuted = lowestIndexExecuted + 1;
+    if (!intervals.buyActive.Test(intervalBelowLowestIntervalExecuted))
     {
         return;
     }
 
-    intervalBelowLowestIntervalExecuted.BUY.active = false;
-    intervalBelowLowestIntervalExecuted.BUY.crossed = false;
-    intervalBelowLowestIntervalExecuted.SELL.active = true;
-    intervalBelowLowestIntervalExecuted.SELL.crossed = false;
+    RemoveOpenPosition(stockState, intervalBelowLowestIntervalExecuted);
+    SetSellActive(intervals, intervalBelowLowestIntervalExecuted);
+    AddOpenPosition(stockState, intervalBelowLowestIntervalExecuted);
 
-    auto& topIntervalExecuted = intervals[indexesToExecute[0]];
-    topIntervalExecuted.BUY.active = true;
-    topIntervalExecuted.BUY.crossed = false;
-    topIntervalExecuted.SELL.active = false;
-    topIntervalExecuted.SELL.crossed = false;
+    const int topIntervalExecuted = toExecute.First();
+    RemoveOpenPosition(stockState, topIntervalExecuted);
+    SetBuyActive(intervals, topIntervalExecuted);
+    AddOpenPosition(stockState, topIntervalExecuted);
 
-    for (auto& interval : intervals)
-    {
-        interval.BUY.price = interval.BUY.price + stockState.spaceBetweenIntervals;
-        interval.SELL.price = interval.SELL.price + stockState.spaceBetweenIntervals;
-    }
+    ShiftLadderPrices(intervals, stockState.spaceBetweenIntervals);
 }
 
-void CorrectBadSellIfRequired(
-    StockState& stockState, std::vector<int>& indexesToExecute
-)
+void CorrectBadSellIfRequired(StockState& stockState, const IntervalMask& toExecute)
 {
-    int highestIndexExecuted = indexesToExecute[0];
+    int highestIndexExecuted = toExecute.First();
     if (highestIndexExecuted == 0)
     {
         return;
     }
 
     auto& intervals = stockState.intervals;
-    auto& intervalAboveHighestIntervalExecuted = intervals[highestIndexExecuted - 1];
-    if (!intervalAboveHighestIntervalExecuted.SELL.active)
+    const int intervalAboveHighestIntervalExecuted = highestIndexExecuted - 1;
+    if (!intervals.sellActive.Test(intervalAboveHighestIntervalExecuted))
     {
         return;
     }
 
-    intervalAboveHighestIntervalExecuted.SELL.active = false;
-    intervalAboveHighestIntervalExecuted.SELL.crossed = false;
-    intervalAboveHighestIntervalExecuted.BUY.active = true;
-    intervalAboveHighestIntervalExecuted.BUY.crossed = false;
+    RemoveOpenPosition(stockState, intervalAboveHighestIntervalExecuted);
+    SetBuyActive(intervals, intervalAboveHighestIntervalExecuted);
+    AddOpenPosition(stockState, intervalAboveHighestIntervalExecuted);
 
-    auto& bottomIntervalExecuted = intervals[indexesToExecute.back()];
-    bottomIntervalExecuted.SELL.active = true;
-    bottomIntervalExecuted.SELL.crossed = false;
-    bottomIntervalExecuted.BUY.active = false;
-    bottomIntervalExecuted.BUY.crossed = false;
+    const int bottomIntervalExecuted = toExecute.Last();
+    RemoveOpenPosition(stockState, bottomIntervalExecuted);
+    SetSellActive(intervals, bottomIntervalExecuted);
+    AddOpenPosition(stockState, bottomIntervalExecuted);
 
-    for (auto& interval : intervals)
-    {
-        interval.BUY.price = interval.BUY.price - stockState.spaceBetweenIntervals;
-        interval.SELL.price = interval.SELL.price - stockState.spaceBetweenIntervals;
-    }
+    ShiftLadderPrices(intervals, -stockState.spaceBetweenIntervals);
 }
 
-void AddSkippedBuysIfRequired(
-    StockState& stockState, std::vector<int>& indexesToExecute
-)
+// Static intervals: every active BUY below the lowest interval bought is bought too.
+void AddSkippedBuysIfRequired(StockState& stockState, IntervalMask& toExecute)
 {
-    if (indexesToExecute.empty())
+    if (!toExecute.Any())
     {
         return;
     }
 
     const auto& intervals = stockState.intervals;
-    int bottomOriginalIndexToExecute = indexesToExecute.back();
-    for (int i = intervals.size() - 1; i > bottomOriginalIndexToExecute; --i)
+    const int bottomOriginalIndexToExecute = toExecute.Last();
+    for (int w = 0; w < toExecute.GetWordCount(); ++w)
     {
-        const auto& interval = intervals[i];
-
-        if (interval.BUY.active)
-        {
-            indexesToExecute.push_back(i);
-        }
+        toExecute.words[w] |=
+            intervals.buyActive.words[w] &
+            GetRangeWord(w, bottomOriginalIndexToExecute + 1, intervals.size());
     }
 }
 
-void AddSkippedSellsIfRequired(
-    StockState& stockState, std::vector<int>& indexesToExecute
-)
+// Static intervals: every active SELL above the highest interval sold is sold too.
+void AddSkippedSellsIfRequired(StockState& stockState, IntervalMask& toExecute)
 {
-    if (indexesToExecute.empty())
+    if (!toExecute.Any())
     {
         return;
     }
 
     const auto& intervals = stockState.intervals;
-    int topOriginalIndexToExecute = indexesToExecute[0];
-    for (int i = 0; i < topOriginalIndexToExecute; ++i)
+    const int topOriginalIndexToExecute = toExecute.First();
+    for (int w = 0; w < toExecute.GetWordCount(); ++w)
     {
-        const auto& interval = intervals[i];
-
-        if (interval.SELL.active)
-        {
-            indexesToExecute.insert(indexesToExecute.begin(), i);
-        }
+        toExecute.words[w] |= intervals.sellActive.words[w] &
+                              GetRangeWord(w, 0, topOriginalIndexToExecute);
     }
 }
@@ -7,13 +7,62 @@
 
 Snapshot ReconcileStockPosition(const std::string& stock, StockState& stockState);
 
+// Generic reconcile step: branches on stockState.isStaticIntervals and walks every
+// interval mask word.
+void ReconcileStockPositionOnSnapshot(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+);
+
+// The reconcile step with the interval mode and the number of interval mask words
+// fixed at compile time (kDynamicNumWords for any ladder size). Instantiated for both
+// modes with kNumWords 1, which covers ladders of up to 64 intervals, and
+// kDynamicNumWords.
+template <bool kIsStaticIntervals, int kNumWords>
+void ReconcileStockPositionOnSnapshotFor(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+);
+
+// Calls function.template operator()<kIsStaticIntervals, kNumWords>() with the
+// instantiation matching the stock's interval mode and ladder size.
+template <typename Function>
+decltype(auto) DispatchOnIntervalKernel(
+    const StockState& stockState, Function&& function
+)
+{
+    const bool isSingleWord =
+        IntervalMask::GetNumWords(stockState.intervals.size()) == 1;
+
+    if (stockState.isStaticIntervals && isSingleWord)
+    {
+        return function.template operator()<true, 1>();
+    }
+    else if (stockState.isStaticIntervals)
+    {
+        return function.template operator()<true, kDynamicNumWords>();
+    }
+    else if (isSingleWord)
+    {
+        return function.template operator()<false, 1>();
+    }
+
+    return function.template operator()<false, kDynamicNumWords>();
+}
+
 bool IsWideBidAskSpread(const Snapshot& snapshot, const StockState& stockState);
 
 bool CheckCrossings(StockState& stockState, const Snapshot& snapshot);
 
-std::vector<int> GetNumToBuy(StockState& stockState, const Snapshot& snapshot);
+// GetNumToBuy/GetNumToSell leave the intervals to execute in
+// stockState.intervals.toExecute and return how many there are.
+int GetNumToBuy(StockState& stockState, const Snapshot& snapshot);
 
-std::vector<int> GetNumToSell(StockState& stockState, const Snapshot& snapshot);
+int GetNumToSell(StockState& stockState, const Snapshot& snapshot);
+
+template <bool kIsStaticIntervals, int kNumWords>
+int GetNumToBuyFor(StockState& stockState, const Snapshot& snapshot);
+
+template <bool kIsStaticIntervals, int kNumWords>
+int GetNumToSellFor(StockState& stockState, const Snapshot& snapshot);
 
 bool IsSnapshotChange(const Snapshot& snapshot, const StockState& stockState);
 
@@ -27,31 +76,59 @@ void SetNewPosition(
 
 void UpdateSnaphotOnState(StockState& stockState, const Snapshot& snapshot);
 
-void CorrectBadBuyIfRequired(
-    StockState& stockState, std::vector<int>& indexesToExecute
-);
+void CorrectBadBuyIfRequired(StockState& stockState, const IntervalMask& toExecute);
 
-void CorrectBadSellIfRequired(
-    StockState& stockState, std::vector<int>& indexesToExecute
-);
+void CorrectBadSellIfRequired(StockState& stockState, const IntervalMask& toExecute);
 
-void AddSkippedBuysIfRequired(
-    StockState& stockState, std::vector<int>& indexesToExecute
-);
+void AddSkippedBuysIfRequired(StockState& stockState, IntervalMask& toExecute);
 
-void AddSkippedSellsIfRequired(
-    StockState& stockState, std::vector<int>& indexesToExecute
-);
+void AddSkippedSellsIfRequired(StockState& stockState, IntervalMask& toExecute);
 
 void UpdateRealizedPnL(
     StockState& stockState,
-    const std::vector<int>& executedIndices,
+    const IntervalMask& executedIntervals,
     const std::string& orderSide,
-    Decimal price
+    FixedPrice price
 );
 
 void UpdateSnaphotOnState(
     const std::string& stock, StockState& stockState, const Snapshot& snapshot
 );
 
+// EXIT_PNL_CHECK: recompute exit PnL with a full interval scan on every update and
+// throw if it differs from the open position totals.
+bool IsExitPnLCheck();
+
+void AddOpenPosition(StockState& stockState, int index);
+
+void RemoveOpenPosition(StockState& stockState, int index);
+
+void InitializeOpenPositionTotals(StockState& stockState);
+
+FixedPrice GetExitPnLByFullScan(const StockState& stockState);
+
+// Exit PnL at the last quote, from the open position totals.
+FixedPrice GetExitPnL(const StockState& stockState);
+
+FixedPrice GetExitPnLAtQuote(
+    const StockState& stockState, FixedPrice bid, FixedPrice ask
+);
+
+// What exit PnL percentages are taken of: initialPrice * (targetPosition +
+// sharesPerInterval).
+FixedPrice GetPercentageDenominator(const StockState& stockState);
+
+// 0 when the denominator is not positive.
+FixedPrice GetExitPnLAsPercentage(const StockState& stockState, FixedPrice exitPnL);
+
+// Whether an exit PnL percentage would set one of the reached_*_percentage_profit
+// flags that is not set yet.
+bool IsUnreachedProfitThresholdAtOrBelow(
+    const StockState& stockState, FixedPrice exitPnLAsPercentage
+);
+
+// The lowest profit threshold whose reached_*_percentage_profit flag is not set yet,
+// or FixedPrice::Max() once all are.
+FixedPrice GetLowestUnreachedProfitThreshold(const StockState& stockState);
+
 void UpdateExitPnL(StockState& stockState);
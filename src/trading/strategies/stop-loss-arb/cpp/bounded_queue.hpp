@@ -0,0 +1,87 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+// Multi-producer, multi-consumer FIFO holding at most `capacity` items. Push blocks
+// while the queue is full, which holds producers back to the pace of the consumers.
+template <typename T>
+struct BoundedQueue
+{
+    explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+    // Returns false, dropping the item, if the queue was closed.
+    bool Push(T item)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        notFull.wait(guard, [&]() { return items.size() < capacity || isClosed; });
+
+        if (isClosed)
+        {
+            return false;
+        }
+
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+
+        return true;
+    }
+
+    // Blocks until an item is available. Returns nullopt once the queue is closed and
+    // drained.
+    std::optional<T> Pop()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        notEmpty.wait(guard, [&]() { return !items.empty() || isClosed; });
+
+        if (items.empty())
+        {
+            return std::nullopt;
+        }
+
+        T item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+
+        return item;
+    }
+
+    // Blocks like Pop, then also takes whatever else is queued, up to `maxItems`.
+    // Returns an empty batch once the queue is closed and drained.
+    std::vector<T> PopBatch(size_t maxItems)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        notEmpty.wait(guard, [&]() { return !items.empty() || isClosed; });
+
+        std::vector<T> batch;
+        while (!items.empty() && batch.size() < maxItems)
+        {
+            batch.push_back(std::move(items.front()));
+            items.pop_front();
+        }
+        notFull.notify_all();
+
+        return batch;
+    }
+
+    // Wakes every waiting Push and Pop; items already queued can still be popped.
+    void Close()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        isClosed = true;
+
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    const size_t capacity;
+
+    std::mutex lock;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<T> items;
+    bool isClosed = false;
+};
@@ -0,0 +1,458 @@
+#include "config_lanes.hpp"
+
+#include <algorithm>
+#include <format>
+#include <limits>
+
+#include "algo.hpp"
+#include "interval_ladder.hpp"
+#include "price_simulator.hpp"
+#include "repeated_quotes.hpp"
+#include "simulate_day.hpp"
+
+using namespace std;
+
+const int kNumConfigLanes = 8;
+
+bool IsLaneKernelDisabled()
+{
+    static const bool isLaneKernelDisabled = IsTruthyEnv("NO_LANE_KERNEL");
+    return isLaneKernelDisabled;
+}
+
+bool IsLaneKernelCheck()
+{
+    static const bool isLaneKernelCheck = IsTruthyEnv("LANE_KERNEL_CHECK");
+    return isLaneKernelCheck;
+}
+
+// One array per field, indexed by lane, all in ticks. Flags are 0 or 1 so they
+// combine with & and | like vector masks.
+struct ConfigLanes
+{
+    int64_t isUsed[kNumConfigLanes];
+
+    // Whether quiet snapshots may skip the scalar step: the lane's exit PnL can be
+    // computed from its totals and as a percentage of a positive amount.
+    int64_t isFast[kNumConfigLanes];
+
+    // Nothing crosses or executes while askFloor <= ask < askCeiling and
+    // bidFloor < bid <= bidCeiling.
+    int64_t askFloor[kNumConfigLanes];
+    int64_t askCeiling[kNumConfigLanes];
+    int64_t bidFloor[kNumConfigLanes];
+    int64_t bidCeiling[kNumConfigLanes];
+
+    // Snapshots with a spread this wide or wider are skipped.
+    int64_t spaceBetweenIntervals[kNumConfigLanes];
+
+    // GetExitPnLAtQuote as exitPnLBase + bid * longShares - ask * shortShares.
+    int64_t hasPosition[kNumConfigLanes];
+    int64_t exitPnLBase[kNumConfigLanes];
+    int64_t longShares[kNumConfigLanes];
+    int64_t shortShares[kNumConfigLanes];
+
+    // The lowest exit PnL at which an unreached profit threshold would be reached.
+    int64_t thresholdExitPnL[kNumConfigLanes];
+
+    // Taken by quiet snapshots since the lane was packed.
+    int64_t lastAsk[kNumConfigLanes];
+    int64_t lastBid[kNumConfigLanes];
+    int64_t hasNewExitPnL[kNumConfigLanes];
+    int64_t exitPnL[kNumConfigLanes];
+    int64_t maxExitPnL[kNumConfigLanes];
+    int64_t minExitPnL[kNumConfigLanes];
+};
+
+// Smallest exit PnL whose percentage is at least `threshold`. Percentages grow with
+// exit PnL, so this is a binary search around the exact quotient.
+int64_t GetThresholdExitPnL(const StockState& stockState, FixedPrice threshold)
+{
+    if (threshold == FixedPrice::Max())
+    {
+        return numeric_limits<int64_t>::max();
+    }
+
+    const FixedPrice denominator = GetPercentageDenominator(stockState);
+    const int64_t estimate =
+        MulDivRounded(threshold.ticks, denominator.ticks, 100 * kFixedPriceScale);
+
+    const auto isReached = [&](int64_t exitPnL)
+    {
+        return GetExitPnLAsPercentage(stockState, FixedPrice::FromTicks(exitPnL)) >=
+               threshold;
+    };
+
+    // One percentage tick is at most denominator / (100 * scale) + 1 exit PnL ticks.
+    const int64_t margin = denominator.ticks / (100 * kFixedPriceScale) + 2;
+    int64_t low = estimate - margin;  // not reached
+    int64_t high = estimate + margin;  // reached
+
+    while (high - low > 1)
+    {
+        const int64_t middle = low + (high - low) / 2;
+        if (isReached(middle))
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle;
+        }
+    }
+
+    return high;
+}
+
+void PackLane(ConfigLanes& lanes, int lane, StockState& stockState)
+{
+    const IntervalLadder& intervals = stockState.intervals;
+
+    // An active BUY crosses once the ask drops below its price and, crossed, executes
+    // once the ask is back at it, unless the position is already at its limit. An
+    // active SELL likewise with the bid above, then back at, its price.
+    int64_t askFloor = numeric_limits<int64_t>::min();
+    int64_t askCeiling = numeric_limits<int64_t>::max();
+    int64_t bidFloor = numeric_limits<int64_t>::min();
+    int64_t bidCeiling = numeric_limits<int64_t>::max();
+
+    intervals.buyActive.ForEach(
+        [&](int i)
+        {
+            const int64_t price = GetBuyPrice(intervals, i).ticks;
+            if (!intervals.buyCrossed.Test(i))
+            {
+                askFloor = max(askFloor, price);
+            }
+            else if (stockState.position < intervals.positionLimits[i])
+            {
+                askCeiling = min(askCeiling, price);
+            }
+        }
+    );
+
+    intervals.sellActive.ForEach(
+        [&](int i)
+        {
+            const int64_t price = GetSellPrice(intervals, i).ticks;
+            if (!intervals.sellCrossed.Test(i))
+            {
+                bidCeiling = min(bidCeiling, price);
+            }
+            else if (stockState.position > intervals.positionLimits[i])
+            {
+                bidFloor = max(bidFloor, price);
+            }
+        }
+    );
+
+    lanes.isUsed[lane] = 1;
+    lanes.isFast[lane] = GetPercentageDenominator(stockState) > FixedPrice{};
+    lanes.askFloor[lane] = askFloor;
+    lanes.askCeiling[lane] = askCeiling;
+    lanes.bidFloor[lane] = bidFloor;
+    lanes.bidCeiling[lane] = bidCeiling;
+    lanes.spaceBetweenIntervals[lane] = stockState.spaceBetweenIntervals.ticks;
+
+    lanes.hasPosition[lane] = stockState.position != 0;
+    lanes.exitPnLBase[lane] = 0;
+    lanes.longShares[lane] = 0;
+    lanes.shortShares[lane] = 0;
+
+    if (stockState.position != 0)
+    {
+        // As UpdateExitPnL would on the lane's next quote.
+        if (!stockState.openPositionTotals.initialized)
+        {
+            InitializeOpenPositionTotals(stockState);
+        }
+
+        const auto& totals = stockState.openPositionTotals;
+        const int shares = stockState.sharesPerInterval;
+
+        // Exit PnL of an open interval without a fill price throws in the scalar step.
+        if (totals.numWithoutPrice > 0)
+        {
+            lanes.isFast[lane] = 0;
+        }
+
+        lanes.exitPnLBase[lane] =
+            (stockState.realizedPnL -
+             stockState.brokerageTradingCostPerShare * stockState.position +
+             (totals.soldAtPriceSum - totals.boughtAtPriceSum) * shares)
+                .ticks;
+        lanes.longShares[lane] = static_cast<int64_t>(totals.numLongs) * shares;
+        lanes.shortShares[lane] = static_cast<int64_t>(totals.numShorts) * shares;
+    }
+
+    lanes.thresholdExitPnL[lane] = 0;
+    if (lanes.isFast[lane])
+    {
+        lanes.thresholdExitPnL[lane] = GetThresholdExitPnL(
+            stockState, GetLowestUnreachedProfitThreshold(stockState)
+        );
+    }
+
+    lanes.lastAsk[lane] = stockState.lastAsk.ticks;
+    lanes.lastBid[lane] = stockState.lastBid.ticks;
+    lanes.hasNewExitPnL[lane] = 0;
+    lanes.exitPnL[lane] = stockState.exitPnL.ticks;
+    lanes.maxExitPnL[lane] = numeric_limits<int64_t>::min();
+    lanes.minExitPnL[lane] = numeric_limits<int64_t>::max();
+}
+
+// Writes what quiet snapshots changed back to the state. Percentages only grow with
+// exit PnL, so the extremes of the exit PnL give the extremes of the percentage.
+void UnpackLane(const ConfigLanes& lanes, int lane, StockState& stockState)
+{
+    stockState.lastAsk = FixedPrice::FromTicks(lanes.lastAsk[lane]);
+    stockState.lastBid = FixedPrice::FromTicks(lanes.lastBid[lane]);
+
+    if (!lanes.hasNewExitPnL[lane])
+    {
+        return;
+    }
+
+    stockState.exitPnL = FixedPrice::FromTicks(lanes.exitPnL[lane]);
+    stockState.exitPnLAsPercentage =
+        GetExitPnLAsPercentage(stockState, stockState.exitPnL);
+
+    stockState.maxMovingProfitAsPercentage = max(
+        stockState.maxMovingProfitAsPercentage,
+        GetExitPnLAsPercentage(
+            stockState, FixedPrice::FromTicks(lanes.maxExitPnL[lane])
+        )
+    );
+    stockState.maxMovingLossAsPercentage = min(
+        stockState.maxMovingLossAsPercentage,
+        GetExitPnLAsPercentage(
+            stockState, FixedPrice::FromTicks(lanes.minExitPnL[lane])
+        )
+    );
+}
+
+// The scalar step for one lane, including the repeated seconds of a collapsed
+// snapshot while they trade (see SimulateDayFor).
+void ReconcileLaneOnSnapshot(
+    const std::string& stock, StockState& stockState, const Snapshot& snapshot
+)
+{
+    DispatchOnIntervalKernel(
+        stockState,
+        [&]<bool kIsStaticIntervals, int kNumWords>()
+        {
+            size_t numTradingLogs = stockState.tradingLogs.size();
+            ReconcileStockPositionOnSnapshotFor<kIsStaticIntervals, kNumWords>(
+                stock, stockState, snapshot
+            );
+
+            for (int repeat = 1; repeat < snapshot.repeatCount &&
+                                 stockState.tradingLogs.size() != numTradingLogs;
+                 ++repeat)
+            {
+                numTradingLogs = stockState.tradingLogs.size();
+                ReconcileStockPositionOnSnapshotFor<kIsStaticIntervals, kNumWords>(
+                    stock, stockState, GetRepeatedSnapshot(snapshot, repeat)
+                );
+            }
+        }
+    );
+}
+
+// Up to kNumConfigLanes states through the whole day.
+void SimulateDayOnLanes(
+    const std::string& stock,
+    std::span<StockState> stockStates,
+    std::span<const Snapshot> snapshots
+)
+{
+    ConfigLanes lanes{};
+
+    const int numLanes = static_cast<int>(stockStates.size());
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        PackLane(lanes, lane, stockStates[lane]);
+    }
+
+    for (const Snapshot& snapshot : snapshots)
+    {
+        // Skipped by every lane's reconcile step.
+        if (!snapshot.bid || !snapshot.ask)
+        {
+            continue;
+        }
+
+        const int64_t ask = snapshot.ask.ticks;
+        const int64_t bid = snapshot.bid.ticks;
+        const int64_t spread = ask - bid;
+
+        int64_t needsScalarStep[kNumConfigLanes];
+
+        for (int lane = 0; lane < kNumConfigLanes; ++lane)
+        {
+            const int64_t isSkipped = spread >= lanes.spaceBetweenIntervals[lane];
+
+            const int64_t isQuiet =
+                (ask >= lanes.askFloor[lane]) & (ask < lanes.askCeiling[lane]) &
+                (bid > lanes.bidFloor[lane]) & (bid <= lanes.bidCeiling[lane]);
+
+            const int64_t isChanged =
+                (ask != lanes.lastAsk[lane]) | (bid != lanes.lastBid[lane]);
+            const int64_t updatesExitPnL = isChanged & lanes.hasPosition[lane];
+
+            const int64_t exitPnL = lanes.exitPnLBase[lane] +
+                                    bid * lanes.longShares[lane] -
+                                    ask * lanes.shortShares[lane];
+            const int64_t reachesThreshold =
+                updatesExitPnL & (exitPnL >= lanes.thresholdExitPnL[lane]);
+
+            const int64_t isTaken = lanes.isUsed[lane] & (isSkipped ^ 1);
+            const int64_t isFastStep =
+                isTaken & lanes.isFast[lane] & isQuiet & (reachesThreshold ^ 1);
+            const int64_t takesExitPnL = isFastStep & updatesExitPnL;
+
+            needsScalarStep[lane] = isTaken & (isFastStep ^ 1);
+
+            lanes.lastAsk[lane] = isFastStep ? ask : lanes.lastAsk[lane];
+            lanes.lastBid[lane] = isFastStep ? bid : lanes.lastBid[lane];
+
+            lanes.exitPnL[lane] = takesExitPnL ? exitPnL : lanes.exitPnL[lane];
+            lanes.maxExitPnL[lane] = takesExitPnL
+                                         ? max(lanes.maxExitPnL[lane], exitPnL)
+                                         : lanes.maxExitPnL[lane];
+            lanes.minExitPnL[lane] = takesExitPnL
+                                         ? min(lanes.minExitPnL[lane], exitPnL)
+                                         : lanes.minExitPnL[lane];
+            lanes.hasNewExitPnL[lane] |= takesExitPnL;
+        }
+
+        int64_t anyNeedsScalarStep = 0;
+        for (int lane = 0; lane < kNumConfigLanes; ++lane)
+        {
+            anyNeedsScalarStep |= needsScalarStep[lane];
+        }
+
+        if (!anyNeedsScalarStep)
+        {
+            continue;
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            if (needsScalarStep[lane])
+            {
+                StockState& stockState = stockStates[lane];
+
+                UnpackLane(lanes, lane, stockState);
+                ReconcileLaneOnSnapshot(stock, stockState, snapshot);
+                PackLane(lanes, lane, stockState);
+            }
+        }
+    }
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        UnpackLane(lanes, lane, stockStates[lane]);
+    }
+}
+
+bool IsSameDayResult(const DayResult& result, const DayResult& expected)
+{
+    return result.position == expected.position &&
+           result.numTrades == expected.numTrades &&
+           result.realizedPnL == expected.realizedPnL &&
+           result.exitPnL == expected.exitPnL &&
+           result.exitPnLAsPercentage == expected.exitPnLAsPercentage &&
+           result.maxMovingProfitAsPercentage == expected.maxMovingProfitAsPercentage &&
+           result.maxMovingLossAsPercentage == expected.maxMovingLossAsPercentage &&
+           result.reached_1_percentage_profit == expected.reached_1_percentage_profit &&
+           result.max_loss_when_reached_1_percentage_profit ==
+               expected.max_loss_when_reached_1_percentage_profit &&
+           result.reached_0_75_percentage_profit ==
+               expected.reached_0_75_percentage_profit &&
+           result.max_loss_when_reached_0_75_percentage_profit ==
+               expected.max_loss_when_reached_0_75_percentage_profit &&
+           result.reached_0_5_percentage_profit ==
+               expected.reached_0_5_percentage_profit &&
+           result.max_loss_when_reached_0_5_percentage_profit ==
+               expected.max_loss_when_reached_0_5_percentage_profit &&
+           result.reached_0_25_percentage_profit ==
+               expected.reached_0_25_percentage_profit &&
+           result.max_loss_when_reached_0_25_percentage_profit ==
+               expected.max_loss_when_reached_0_25_percentage_profit;
+}
+
+bool IsSameTradingLog(const StockState& stockState, const StockState& expected)
+{
+    return ranges::equal(
+        stockState.tradingLogs,
+        expected.tradingLogs,
+        [](const TradingLog& log, const TradingLog& expectedLog)
+        {
+            return log.timeStamp == expectedLog.timeStamp &&
+                   log.action == expectedLog.action &&
+                   log.price == expectedLog.price &&
+                   log.previousPosition == expectedLog.previousPosition &&
+                   log.newPosition == expectedLog.newPosition;
+        }
+    );
+}
+
+std::vector<DayResult> SimulateDayForConfigs(
+    const std::string& stock,
+    std::span<StockState> stockStates,
+    std::span<const Snapshot> snapshots
+)
+{
+    vector<StockState> expectedStates;
+    if (IsLaneKernelCheck())
+    {
+        expectedStates.assign(stockStates.begin(), stockStates.end());
+    }
+
+    vector<size_t> numTradingLogs;
+    for (const StockState& stockState : stockStates)
+    {
+        numTradingLogs.push_back(stockState.tradingLogs.size());
+    }
+
+    for (size_t first = 0; first < stockStates.size(); first += kNumConfigLanes)
+    {
+        SimulateDayOnLanes(
+            stock,
+            stockStates.subspan(
+                first, min<size_t>(kNumConfigLanes, stockStates.size() - first)
+            ),
+            snapshots
+        );
+    }
+
+    vector<DayResult> results;
+    for (size_t i = 0; i < stockStates.size(); ++i)
+    {
+        const int numTrades =
+            static_cast<int>(stockStates[i].tradingLogs.size() - numTradingLogs[i]);
+        results.push_back(GetDayResult(stockStates[i], numTrades));
+    }
+
+    for (size_t i = 0; i < expectedStates.size(); ++i)
+    {
+        const DayResult expected =
+            SimulateDay(stock, expectedStates[i], snapshots, nullptr);
+
+        if (!IsSameDayResult(results[i], expected) ||
+            !IsSameTradingLog(stockStates[i], expectedStates[i]))
+        {
+            throw exception(format(
+                                "Lane kernel differs from SimulateDay for {} on {}, "
+                                "config {}",
+                                stock,
+                                stockStates[i].date,
+                                i
+            )
+                                .c_str());
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+// NO_LANE_KERNEL: sweeps run each config through SimulateDay on its own.
+bool IsLaneKernelDisabled();
+
+// LANE_KERNEL_CHECK: SimulateDayForConfigs also runs every config through SimulateDay
+// and throws if any lane's result or trading log differs.
+bool IsLaneKernelCheck();
+
+// SimulateDay for several ladder configurations of the same stock-day at once; the
+// states are updated and the results returned as SimulateDay would for each.
+//
+// The configs are packed kNumConfigLanes to a pass, each lane holding the quiet band
+// of its ladder (the quotes at which nothing crosses or executes) and the terms of its
+// exit PnL. Every snapshot is broadcast to all lanes and, branch-free, each lane that
+// stays in its band only takes the quote and its exit PnL: the compares, multiplies
+// and selects run across the lanes as vector instructions. A lane whose ladder would
+// change, or whose exit PnL reaches an unreached profit threshold, takes the scalar
+// reconcile step (CheckCrossings, GetNumToBuy, GetNumToSell, ...) for that snapshot
+// and is then repacked.
+std::vector<DayResult> SimulateDayForConfigs(
+    const std::string& stock,
+    std::span<StockState> stockStates,
+    std::span<const Snapshot> snapshots
+);
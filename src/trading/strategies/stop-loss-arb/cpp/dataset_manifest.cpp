@@ -0,0 +1,331 @@
+#include "dataset_manifest.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <thread>
+
+#include "numeric_conversions.hpp"
+#include "price_simulator.hpp"
+#include "utils.hpp"
+
+using namespace std;
+
+const char kDatasetManifestHeader[] =
+    "date\tticker\tfile\tfile_size\tmodified_time\tnum_snapshots\tfirst_ask\t"
+    "first_bid\thigh\tlow\tcontent_hash";
+const int kNumDatasetManifestColumns = 11;
+
+string GetDatasetManifestPath(const string& root)
+{
+    return (filesystem::path(root) / kDatasetManifestFileName).string();
+}
+
+template <typename Integer>
+bool TryParseInteger(string_view text, Integer& value, int base = 10)
+{
+    const auto [end, error] =
+        from_chars(text.data(), text.data() + text.size(), value, base);
+    return error == errc() && end == text.data() + text.size();
+}
+
+bool TryParseDatasetManifestRow(string_view row, DatasetManifestEntry& entry)
+{
+    string_view fields[kNumDatasetManifestColumns];
+    for (int i = 0; i < kNumDatasetManifestColumns; ++i)
+    {
+        const size_t end = row.find('\t');
+        if ((end == string_view::npos) != (i == kNumDatasetManifestColumns - 1))
+        {
+            return false;
+        }
+
+        fields[i] = row.substr(0, end);
+        row.remove_prefix(end == string_view::npos ? row.size() : end + 1);
+    }
+
+    entry.date = fields[0];
+    entry.ticker = fields[1];
+    entry.file = fields[2];
+
+    return TryParseInteger(fields[3], entry.fileSize) &&
+           TryParseInteger(fields[4], entry.modifiedTime) &&
+           TryParseInteger(fields[5], entry.numSnapshots) &&
+           TryParseFixedPrice(fields[6], entry.firstAsk) &&
+           TryParseFixedPrice(fields[7], entry.firstBid) &&
+           TryParseFixedPrice(fields[8], entry.high) &&
+           TryParseFixedPrice(fields[9], entry.low) &&
+           TryParseInteger(fields[10], entry.contentHash, 16);
+}
+
+DatasetManifest ReadDatasetManifest(const std::string& root)
+{
+    const string path = GetDatasetManifestPath(root);
+
+    DatasetManifest manifest;
+
+    ifstream file(path, ios::binary);
+    if (!file.is_open())
+    {
+        return manifest;
+    }
+
+    string row;
+    if (!getline(file, row) || row != kDatasetManifestHeader)
+    {
+        throw exception(format("Error: {} is not a dataset manifest", path).c_str());
+    }
+
+    for (int rowNumber = 2; getline(file, row); ++rowNumber)
+    {
+        DatasetManifestEntry entry{};
+        if (!TryParseDatasetManifestRow(row, entry))
+        {
+            throw exception(
+                format("Error: Invalid row {} in dataset manifest {}", rowNumber, path)
+                    .c_str()
+            );
+        }
+
+        manifest.entries.push_back(std::move(entry));
+    }
+
+    return manifest;
+}
+
+void WriteDatasetManifest(const std::string& root, const DatasetManifest& manifest)
+{
+    const string path = GetDatasetManifestPath(root);
+    const string temporaryPath = path + ".tmp";
+    {
+        ofstream out(temporaryPath, ios::binary | ios::trunc);
+        if (!out.is_open())
+        {
+            throw exception(
+                format("Error: Unable to open file {}", temporaryPath).c_str()
+            );
+        }
+
+        out << kDatasetManifestHeader << '\n';
+        for (const auto& entry : manifest.entries)
+        {
+            out << format(
+                "{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{:016x}\n",
+                entry.date,
+                entry.ticker,
+                entry.file,
+                entry.fileSize,
+                entry.modifiedTime,
+                entry.numSnapshots,
+                entry.firstAsk.str(),
+                entry.firstBid.str(),
+                entry.high.str(),
+                entry.low.str(),
+                entry.contentHash
+            );
+        }
+
+        if (!out)
+        {
+            throw exception(
+                format("Error: Unable to write file {}", temporaryPath).c_str()
+            );
+        }
+    }
+
+    filesystem::rename(temporaryPath, path);
+}
+
+// Fills in everything but the file fields from the day's snapshots.
+void SetSnapshotStatistics(
+    DatasetManifestEntry& entry, const vector<Snapshot>& snapshots
+)
+{
+    entry.numSnapshots = snapshots.size();
+    entry.firstAsk = snapshots.empty() ? FixedPrice{} : snapshots[0].ask;
+    entry.firstBid = snapshots.empty() ? FixedPrice{} : snapshots[0].bid;
+    entry.high = FixedPrice{};
+    entry.low = FixedPrice{};
+    entry.contentHash = kFnvOffsetBasis;
+
+    for (const auto& snapshot : snapshots)
+    {
+        entry.high = max(entry.high, snapshot.ask);
+        if (snapshot.bid && (!entry.low || snapshot.bid < entry.low))
+        {
+            entry.low = snapshot.bid;
+        }
+
+        HashInteger(entry.contentHash, snapshot.ask.ticks);
+        HashInteger(entry.contentHash, snapshot.bid.ticks);
+        HashInteger(entry.contentHash, snapshot.timestamp);
+    }
+}
+
+int UpdateDatasetManifest(const std::string& root)
+{
+    const DatasetManifest previous = ReadDatasetManifest(root);
+
+    map<pair<string, string>, const DatasetManifestEntry*> previousEntries;
+    for (const auto& entry : previous.entries)
+    {
+        previousEntries[{entry.date, entry.ticker}] = &entry;
+    }
+
+    // <root>/<YYYY>/<MM>/<YYYY-MM-DD>/<TICKER>.bin or .json; a converted .bin wins over
+    // its .json unless it is older, as in GetSnapshotsForStockOnDate.
+    map<pair<string, string>, DatasetManifestEntry> days;
+    for (const auto& file : filesystem::recursive_directory_iterator(root))
+    {
+        const auto& path = file.path();
+        const auto extension = path.extension();
+        if (!file.is_regular_file() || (extension != ".bin" && extension != ".json"))
+        {
+            continue;
+        }
+
+        const auto relativePath = path.lexically_relative(root);
+        if (distance(relativePath.begin(), relativePath.end()) != 4)
+        {
+            continue;
+        }
+
+        DatasetManifestEntry entry{};
+        entry.date = path.parent_path().filename().string();
+        entry.ticker = path.stem().string();
+        entry.file = relativePath.generic_string();
+        entry.fileSize = file.file_size();
+        entry.modifiedTime = file.last_write_time().time_since_epoch().count();
+
+        auto& day = days[{entry.date, entry.ticker}];
+        // Of a .bin and its .json the newer wins, the .bin on a tie.
+        const bool isBinary = extension == ".bin";
+        if (day.file.empty() || (isBinary ? entry.modifiedTime >= day.modifiedTime
+                                          : entry.modifiedTime > day.modifiedTime))
+        {
+            day = std::move(entry);
+        }
+    }
+
+    vector<DatasetManifestEntry*> changed;
+    for (auto& [key, entry] : days)
+    {
+        const auto it = previousEntries.find(key);
+        if (it != previousEntries.end() && it->second->file == entry.file &&
+            it->second->fileSize == entry.fileSize &&
+            it->second->modifiedTime == entry.modifiedTime)
+        {
+            entry = *it->second;
+            continue;
+        }
+
+        changed.push_back(&entry);
+    }
+
+    atomic<size_t> nextEntry{0};
+
+    const int numThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+
+    vector<thread> threads;
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (size_t i = nextEntry++; i < changed.size(); i = nextEntry++)
+                {
+                    DatasetManifestEntry& entry = *changed[i];
+                    const string path = (filesystem::path(root) / entry.file).string();
+
+                    try
+                    {
+                        const vector<Snapshot> snapshots =
+                            entry.file.ends_with(".bin") ? ReadSnapshotsBinaryFile(path)
+                                                         : ReadSnapshotsJsonFile(path);
+                        SetSnapshotStatistics(entry, snapshots);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        Print(format("Skipped {}: {}", path, e.what()));
+                        entry.file.clear();
+                    }
+                }
+            }
+        );
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    DatasetManifest manifest;
+    for (auto& [key, entry] : days)
+    {
+        // Cleared for files that failed to read.
+        if (!entry.file.empty())
+        {
+            manifest.entries.push_back(std::move(entry));
+        }
+    }
+
+    WriteDatasetManifest(root, manifest);
+
+    return static_cast<int>(changed.size());
+}
+
+struct LoadedDatasetManifest
+{
+    DatasetManifest manifest;
+    map<pair<string, string>, const DatasetManifestEntry*> byDateAndTicker;
+};
+
+const LoadedDatasetManifest& GetLoadedDatasetManifest()
+{
+    static const auto loaded = []()
+    {
+        auto loaded = make_unique<LoadedDatasetManifest>();
+        loaded->manifest = ReadDatasetManifest(GetHistoricalDataRootPath());
+
+        for (const auto& entry : loaded->manifest.entries)
+        {
+            loaded->byDateAndTicker[{entry.date, entry.ticker}] = &entry;
+        }
+
+        return loaded;
+    }();
+
+    return *loaded;
+}
+
+std::vector<const DatasetManifestEntry*> GetDatasetManifestEntriesOnDate(
+    const std::string& date
+)
+{
+    const auto& byDateAndTicker = GetLoadedDatasetManifest().byDateAndTicker;
+
+    vector<const DatasetManifestEntry*> entries;
+    for (auto it = byDateAndTicker.lower_bound({date, ""});
+         it != byDateAndTicker.end() && it->first.first == date;
+         ++it)
+    {
+        entries.push_back(it->second);
+    }
+
+    return entries;
+}
+
+const DatasetManifestEntry* FindDatasetManifestEntry(
+    const std::string& date, const std::string& ticker
+)
+{
+    const auto& byDateAndTicker = GetLoadedDatasetManifest().byDateAndTicker;
+
+    const auto it = byDateAndTicker.find({date, ticker});
+    return it == byDateAndTicker.end() ? nullptr : it->second;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "fixed_price.hpp"
+
+// Index of a historical dataset, <root>/manifest.tsv: one tab-separated row per
+// (date, ticker) day with where its snapshots are and what a run needs to know about
+// them, so runs can be planned without listing folders or parsing snapshot files.
+// Written by UpdateDatasetManifest (build_dataset_manifest.js).
+
+const char kDatasetManifestFileName[] = "manifest.tsv";
+
+struct DatasetManifestEntry
+{
+    std::string date;
+    std::string ticker;
+    std::string file;  // relative to the dataset root; .bin if converted, else .json
+    uint64_t fileSize;
+    int64_t modifiedTime;  // file clock ticks, not a calendar time
+    uint64_t numSnapshots;
+    FixedPrice firstAsk;
+    FixedPrice firstBid;
+    FixedPrice high;  // highest ask
+    FixedPrice low;   // lowest non-missing bid
+    uint64_t contentHash;  // of the snapshots, so a .bin and its .json hash the same
+};
+
+// Entries are sorted by date, then ticker.
+struct DatasetManifest
+{
+    std::vector<DatasetManifestEntry> entries;
+};
+
+// An empty manifest if `root` has none yet. Throws if the file is malformed.
+DatasetManifest ReadDatasetManifest(const std::string& root);
+
+void WriteDatasetManifest(const std::string& root, const DatasetManifest& manifest);
+
+// Brings the manifest of `root` up to date and writes it: only snapshot files that
+// are new or whose size or modification time changed are read (on all cores), and
+// days whose files are gone are dropped. Files that fail to read are reported and
+// left out. Returns how many files were read.
+int UpdateDatasetManifest(const std::string& root);
+
+// Days of `date` in the manifest of GetHistoricalDataRootPath(), which is read once per
+// process. Empty if the manifest does not have the date.
+std::vector<const DatasetManifestEntry*> GetDatasetManifestEntriesOnDate(
+    const std::string& date
+);
+
+// Null if the manifest does not have the day.
+const DatasetManifestEntry* FindDatasetManifestEntry(
+    const std::string& date, const std::string& ticker
+);
@@ -2,6 +2,7 @@
 
 #include <format>
 
+#include "interval_ladder.hpp"
 #include "price_simulator.hpp"
 
 using namespace std;
@@ -19,35 +20,42 @@ void PrintPnLValues(const std::string stock, const StockState& stockState)
     Print("");
 }
 
+// Starts the stock over from its original state, on a fresh random path.
+void RestartFromOriginalState(StockState& stockState, const StockState& originalState)
+{
+    const RandomWalk walk = stockState.randomWalk;
+
+    stockState = originalState;
+    stockState.randomWalk = walk;
+    RestartRandomPrice(stockState.randomWalk);
+}
+
 void DebugUpperOrLowerBound(
     const std::string& upperOrLowerBound,
-    const std::string& stock,
-    std::unordered_map<std::string, StockState>& states,
-    const std::unordered_map<std::string, StockState>& originalStates
+    [[maybe_unused]] const std::string& stock,
+    StockState& stockState,
+    const StockState& originalState
 )
 {
-    if (states[stock].tradingLogs.empty())
+    if (stockState.tradingLogs.empty())
     {
-        RestartRandomPrice();
-        states[stock] = originalStates.at(stock);
+        RestartFromOriginalState(stockState, originalState);
         return;
     }
 
-    // PrintPnLValues(stock, states);
+    // PrintPnLValues(stock, stockState);
 
-    if (upperOrLowerBound == "up" &&
-        states[stock].position < states[stock].targetPosition)
+    if (upperOrLowerBound == "up" && stockState.position < stockState.targetPosition)
     {
         __debugbreak();
     }
     else if (upperOrLowerBound == "down" &&
-             states[stock].position > -states[stock].targetPosition)
+             stockState.position > -stockState.targetPosition)
     {
         __debugbreak();
     }
 
-    RestartRandomPrice();
-    states[stock] = originalStates.at(stock);
+    RestartFromOriginalState(stockState, originalState);
 
     return;
 }
@@ -55,25 +63,24 @@ void DebugUpperOrLowerBound(
 void DebugRandomPrices(
     const Snapshot& snapshot,
     const std::string& stock,
-    std::unordered_map<std::string, StockState>& states,
-    const std::unordered_map<std::string, StockState>& originalStates
+    StockState& stockState,
+    const StockState& originalState
 )
 {
-    auto& stockState = states[stock];
-
-    Decimal aboveTopSell =
-        stockState.intervals[0].SELL.price + stockState.spaceBetweenIntervals;
+    FixedPrice aboveTopSell =
+        GetSellPrice(stockState.intervals, 0) + stockState.spaceBetweenIntervals;
     if (snapshot.bid >= aboveTopSell)
     {
-        DebugUpperOrLowerBound("up", stock, states, originalStates);
+        DebugUpperOrLowerBound("up", stock, stockState, originalState);
         return;
     }
 
-    Decimal belowBottomBuy =
-        stockState.intervals.back().BUY.price - stockState.spaceBetweenIntervals;
+    FixedPrice belowBottomBuy =
+        GetBuyPrice(stockState.intervals, stockState.intervals.size() - 1) -
+        stockState.spaceBetweenIntervals;
     if (snapshot.ask <= belowBottomBuy)
     {
-        DebugUpperOrLowerBound("down", stock, states, originalStates);
+        DebugUpperOrLowerBound("down", stock, stockState, originalState);
         return;
     }
 
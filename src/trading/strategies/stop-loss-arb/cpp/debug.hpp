@@ -1,12 +1,14 @@
 #pragma once
 
+#include <string>
+
 #include "types.hpp"
 
 void DebugRandomPrices(
     const Snapshot& snapshot,
     const std::string& stock,
-    std::unordered_map<std::string, StockState>& states,
-    const std::unordered_map<std::string, StockState>& originalStates
+    StockState& stockState,
+    const StockState& originalState
 );
 
 void PrintPnLValues(const std::string stock, const StockState& stockState);
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Number of decimal places held by a FixedPrice tick. Quotes are on a cent or
+// sub-cent grid, so 4 places is enough for prices; 6 (the default) also keeps the
+// PnL percentages close to what cpp_dec_float<12> produced.
+#ifndef FIXED_PRICE_DECIMALS
+#define FIXED_PRICE_DECIMALS 6
+#endif
+
+static_assert(
+    FIXED_PRICE_DECIMALS == 4 || FIXED_PRICE_DECIMALS == 6,
+    "FIXED_PRICE_DECIMALS must be 4 or 6"
+);
+
+const int kFixedPriceDecimals = FIXED_PRICE_DECIMALS;
+const int64_t kFixedPriceScale = FIXED_PRICE_DECIMALS == 4 ? 10'000 : 1'000'000;
+
+// (a * b) / c rounded half away from zero, with a 128-bit intermediate product.
+inline int64_t MulDivRounded(int64_t a, int64_t b, int64_t c)
+{
+#if defined(__SIZEOF_INT128__)
+    const __int128 product = static_cast<__int128>(a) * b;
+    __int128 quotient = product / c;
+    const __int128 remainder = product % c;
+
+    const __int128 abs_remainder = remainder < 0 ? -remainder : remainder;
+    const __int128 abs_divisor = c < 0 ? -static_cast<__int128>(c) : c;
+    if (2 * abs_remainder >= abs_divisor)
+    {
+        quotient += ((product < 0) != (c < 0)) ? -1 : 1;
+    }
+
+    return static_cast<int64_t>(quotient);
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    int64_t high = 0;
+    const int64_t low = _mul128(a, b, &high);
+
+    int64_t remainder = 0;
+    int64_t quotient = _div128(high, low, c, &remainder);
+
+    const uint64_t abs_remainder = remainder < 0 ? 0 - uint64_t(remainder) : remainder;
+    const uint64_t abs_divisor = c < 0 ? 0 - uint64_t(c) : c;
+    if (abs_remainder >= abs_divisor - abs_remainder)
+    {
+        quotient += ((high < 0) != (c < 0)) ? -1 : 1;
+    }
+
+    return quotient;
+#else
+    const long double exact = static_cast<long double>(a) * b / c;
+    return static_cast<int64_t>(std::llround(exact));
+#endif
+}
+
+// Scaled-integer price: `ticks` units of 10^-kFixedPriceDecimals. Every value the
+// engine handles (quotes, ladder levels, PnL and PnL percentages) is a FixedPrice, so
+// compares and adds in the hot loop are single integer instructions.
+struct FixedPrice
+{
+    int64_t ticks = 0;
+
+    static constexpr FixedPrice FromTicks(int64_t ticks) { return FixedPrice{ticks}; }
+
+    static constexpr FixedPrice FromInt(int64_t value)
+    {
+        return FixedPrice{value * kFixedPriceScale};
+    }
+
+    // Exact for any double that is the nearest binary value of a decimal with at most
+    // kFixedPriceDecimals places, which is what JS numbers like 9.37 are.
+    static FixedPrice FromDouble(double value)
+    {
+        return FixedPrice{std::llround(value * static_cast<double>(kFixedPriceScale))};
+    }
+
+    static constexpr FixedPrice Min()
+    {
+        return FixedPrice{std::numeric_limits<int64_t>::min()};
+    }
+
+    static constexpr FixedPrice Max()
+    {
+        return FixedPrice{std::numeric_limits<int64_t>::max()};
+    }
+
+    double ToDouble() const
+    {
+        return static_cast<double>(ticks) / static_cast<double>(kFixedPriceScale);
+    }
+
+    std::string str() const
+    {
+        const uint64_t magnitude = ticks < 0 ? 0 - uint64_t(ticks) : uint64_t(ticks);
+
+        std::string result = ticks < 0 ? "-" : "";
+        result += std::to_string(magnitude / kFixedPriceScale);
+
+        std::string fraction = std::to_string(magnitude % kFixedPriceScale);
+        fraction.insert(0, kFixedPriceDecimals - fraction.size(), '0');
+        while (!fraction.empty() && fraction.back() == '0')
+        {
+            fraction.pop_back();
+        }
+
+        if (!fraction.empty())
+        {
+            result += "." + fraction;
+        }
+
+        return result;
+    }
+
+    constexpr explicit operator bool() const { return ticks != 0; }
+
+    constexpr bool operator!() const { return ticks == 0; }
+
+    constexpr auto operator<=>(const FixedPrice&) const = default;
+
+    constexpr FixedPrice operator-() const { return FixedPrice{-ticks}; }
+
+    constexpr FixedPrice& operator+=(const FixedPrice& other)
+    {
+        ticks += other.ticks;
+        return *this;
+    }
+
+    constexpr FixedPrice& operator-=(const FixedPrice& other)
+    {
+        ticks -= other.ticks;
+        return *this;
+    }
+
+    friend constexpr FixedPrice operator+(FixedPrice lhs, const FixedPrice& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    friend constexpr FixedPrice operator-(FixedPrice lhs, const FixedPrice& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    friend constexpr FixedPrice operator*(const FixedPrice& price, int64_t quantity)
+    {
+        return FixedPrice{price.ticks * quantity};
+    }
+
+    friend constexpr FixedPrice operator*(int64_t quantity, const FixedPrice& price)
+    {
+        return FixedPrice{price.ticks * quantity};
+    }
+};
+
+static_assert(sizeof(FixedPrice) == sizeof(int64_t));
+
+// (part / whole) * 100, rounded to the nearest tick.
+inline FixedPrice GetPercentage(const FixedPrice& part, const FixedPrice& whole)
+{
+    return FixedPrice::FromTicks(
+        MulDivRounded(part.ticks, 100 * kFixedPriceScale, whole.ticks)
+    );
+}
@@ -0,0 +1,126 @@
+#include "historical_pipeline.hpp"
+
+#include <atomic>
+#include <format>
+#include <memory>
+#include <thread>
+
+#include "bounded_queue.hpp"
+#include "price_simulator.hpp"
+#include "results_sink.hpp"
+#include "snapshot_cache.hpp"
+#include "start.hpp"
+#include "work_stealing_pool.hpp"
+
+using namespace std;
+
+const int kNumLoaderThreads = 2;
+const int kLoadedDaysPerWorker = 2;
+
+struct HistoricalDay
+{
+    string stock;
+    StockState* stockState;
+};
+
+struct LoadedHistoricalDay
+{
+    HistoricalDay day;
+    shared_ptr<const SnapshotDataset> dataset;
+};
+
+void PrintSkippedDay(const HistoricalDay& day, const char* stage, const char* error)
+{
+    Print(format(
+        "Skipped {} on {}: {} failed: {}", day.stock, day.stockState->date, stage, error
+    ));
+}
+
+void RunHistoricalPipeline(
+    std::vector<std::unordered_map<std::string, StockState>>& states_list
+)
+{
+    // Resolved up front: the maps must not be looked up (and possibly inserted into)
+    // from several threads.
+    vector<HistoricalDay> days;
+    for (auto& states : states_list)
+    {
+        for (auto& [stock, stockState] : states)
+        {
+            days.push_back(HistoricalDay{stock, &stockState});
+        }
+    }
+
+    const int numWorkers = GetWorkerPoolSize();
+
+    BoundedQueue<LoadedHistoricalDay> loadedDays(numWorkers * kLoadedDaysPerWorker);
+
+    atomic<size_t> nextDay{0};
+    atomic<int> numLoadersRunning{kNumLoaderThreads};
+
+    vector<thread> loaders;
+    for (int i = 0; i < kNumLoaderThreads; ++i)
+    {
+        loaders.emplace_back(
+            [&]()
+            {
+                for (size_t i = nextDay++; i < days.size(); i = nextDay++)
+                {
+                    const HistoricalDay& day = days[i];
+
+                    shared_ptr<const SnapshotDataset> dataset;
+                    try
+                    {
+                        dataset = GetSnapshotDataset(*day.stockState);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        PrintSkippedDay(day, "loading", e.what());
+                        continue;
+                    }
+
+                    loadedDays.Push(LoadedHistoricalDay{day, std::move(dataset)});
+                }
+
+                if (--numLoadersRunning == 0)
+                {
+                    loadedDays.Close();
+                }
+            }
+        );
+    }
+
+    // Each pool task drains the queue until the loaders are done.
+    RunOnWorkerPool(
+        numWorkers,
+        [&](size_t)
+        {
+            while (auto loadedDay = loadedDays.Pop())
+            {
+                const HistoricalDay& day = loadedDay->day;
+
+                try
+                {
+                    SetHistoricalSnapshots(*day.stockState, loadedDay->dataset);
+                    loadedDay->dataset.reset();
+
+                    const DayResult result =
+                        SimulateHistoricalDay(day.stock, *day.stockState);
+
+                    AppendDayResult(day.stock, *day.stockState, result);
+                }
+                catch (const std::exception& e)
+                {
+                    PrintSkippedDay(day, "simulation", e.what());
+                }
+            }
+        }
+    );
+
+    for (auto& loader : loaders)
+    {
+        loader.join();
+    }
+
+    FlushResults();
+}
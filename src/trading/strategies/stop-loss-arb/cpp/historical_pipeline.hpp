@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+// Backtests every (stock, date) in three stages joined by bounded queues:
+//   - loader threads read and decode upcoming days through the snapshot cache,
+//   - the worker pool only simulates (SimulateHistoricalDay),
+//   - the results sink's writer thread appends each day's result (results_sink.hpp).
+// Full queues stall the stage before them, so at most a fixed number of loaded days
+// are waiting at any time however many dates are run. A day that fails to load or
+// simulate is reported and skipped. Returns once every result is written.
+void RunHistoricalPipeline(
+    std::vector<std::unordered_map<std::string, StockState>>& states_list
+);
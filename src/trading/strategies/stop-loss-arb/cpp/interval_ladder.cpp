@@ -0,0 +1,525 @@
+#include "interval_ladder.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define HAS_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+using namespace std;
+
+// Above this many arithmetic segments the per-segment division loop is no longer
+// cheaper than a binary search.
+const int kMaxDirectlyAddressedSegments = 4;
+
+PriceIndex GetPriceIndex(const std::vector<FixedPrice>& prices)
+{
+    PriceIndex index{};
+
+    const int size = static_cast<int>(prices.size());
+    for (int i = 0; i + 1 < size; ++i)
+    {
+        if (prices[i] <= prices[i + 1])
+        {
+            return index;
+        }
+    }
+
+    index.isDescending = true;
+
+    int begin = 0;
+    while (begin < size)
+    {
+        int end = begin + 1;
+        FixedPrice step{};
+        if (end < size)
+        {
+            step = prices[begin] - prices[end];
+            while (end + 1 < size && prices[end] - prices[end + 1] == step)
+            {
+                end++;
+            }
+            end++;
+        }
+
+        index.segments.push_back(PriceSegment{begin, end, prices[begin], step});
+        begin = end;
+    }
+
+    return index;
+}
+
+// Number of leading prices that are > quote, or >= quote if `orEqual`. The prices must
+// be indexed.
+int CountPricesAbove(
+    const PriceIndex& index,
+    const std::vector<FixedPrice>& prices,
+    FixedPrice quote,
+    bool orEqual
+)
+{
+    if (index.segments.size() > kMaxDirectlyAddressedSegments)
+    {
+        const auto isAbove = [&](const FixedPrice& price)
+        { return orEqual ? price >= quote : price > quote; };
+
+        const auto it = partition_point(prices.begin(), prices.end(), isAbove);
+
+        return static_cast<int>(it - prices.begin());
+    }
+
+    int count = 0;
+    for (const auto& segment : index.segments)
+    {
+        const int length = segment.end - segment.begin;
+        const int64_t distance = segment.top.ticks - quote.ticks;
+
+        int64_t numAbove = 0;
+        if (distance > 0 || (distance == 0 && orEqual))
+        {
+            if (length == 1)
+            {
+                numAbove = 1;
+            }
+            else if (orEqual)
+            {
+                numAbove = distance / segment.step.ticks + 1;
+            }
+            else
+            {
+                numAbove = (distance + segment.step.ticks - 1) / segment.step.ticks;
+            }
+        }
+
+        if (numAbove < length)
+        {
+            return count + static_cast<int>(numAbove);
+        }
+
+        count += length;
+    }
+
+    return count;
+}
+
+
+IntervalLadder GetIntervalLadder(const std::vector<SmoothingInterval>& intervals)
+{
+    IntervalLadder ladder{};
+
+    const int size = static_cast<int>(intervals.size());
+    ladder.buyActive.Resize(size);
+    ladder.buyCrossed.Resize(size);
+    ladder.sellActive.Resize(size);
+    ladder.sellCrossed.Resize(size);
+    ladder.toExecute.Resize(size);
+    ladder.priceMatches.Resize(size);
+
+    for (int i = 0; i < size; ++i)
+    {
+        const auto& interval = intervals[i];
+
+        ladder.types.push_back(interval.type);
+        ladder.positionLimits.push_back(interval.positionLimit);
+        ladder.buyBasePrices.push_back(interval.BUY.price);
+        ladder.sellBasePrices.push_back(interval.SELL.price);
+        ladder.boughtAtPrices.push_back(interval.SELL.boughtAtPrice);
+        ladder.soldAtPrices.push_back(interval.BUY.soldAtPrice);
+
+        if (interval.BUY.active)
+        {
+            ladder.buyActive.Set(i);
+        }
+
+        if (interval.BUY.crossed)
+        {
+            ladder.buyCrossed.Set(i);
+        }
+
+        if (interval.SELL.active)
+        {
+            ladder.sellActive.Set(i);
+        }
+
+        if (interval.SELL.crossed)
+        {
+            ladder.sellCrossed.Set(i);
+        }
+    }
+
+    ladder.buyPriceIndex = GetPriceIndex(ladder.buyBasePrices);
+    ladder.sellPriceIndex = GetPriceIndex(ladder.sellBasePrices);
+
+    return ladder;
+}
+
+std::vector<SmoothingInterval> GetSmoothingIntervals(const IntervalLadder& ladder)
+{
+    vector<SmoothingInterval> intervals(ladder.size());
+
+    for (int i = 0; i < ladder.size(); ++i)
+    {
+        auto& interval = intervals[i];
+
+        interval.type = ladder.types[i];
+        interval.positionLimit = ladder.positionLimits[i];
+
+        interval.BUY.active = ladder.buyActive.Test(i);
+        interval.BUY.crossed = ladder.buyCrossed.Test(i);
+        interval.BUY.price = GetBuyPrice(ladder, i);
+        interval.BUY.soldAtPrice = ladder.soldAtPrices[i];
+
+        interval.SELL.active = ladder.sellActive.Test(i);
+        interval.SELL.crossed = ladder.sellCrossed.Test(i);
+        interval.SELL.price = GetSellPrice(ladder, i);
+        interval.SELL.boughtAtPrice = ladder.boughtAtPrices[i];
+    }
+
+    return intervals;
+}
+
+// How a ladder price has to compare to the quote for an interval to match.
+enum class PriceComparison
+{
+    GREATER,        // price > quote
+    LESS,           // price < quote
+    LESS_EQUAL,     // price <= quote
+    GREATER_EQUAL,  // price >= quote
+};
+
+template <PriceComparison comparison>
+bool IsPriceMatch(FixedPrice price, FixedPrice quote)
+{
+    if constexpr (comparison == PriceComparison::GREATER)
+    {
+        return price > quote;
+    }
+    else if constexpr (comparison == PriceComparison::LESS)
+    {
+        return price < quote;
+    }
+    else if constexpr (comparison == PriceComparison::LESS_EQUAL)
+    {
+        return price <= quote;
+    }
+    else
+    {
+        return price >= quote;
+    }
+}
+
+#if defined(HAS_X86_SIMD)
+// The build targets baseline x86-64, so the vector kernels are compiled for their
+// instruction set on their own and picked at run time. MSVC compiles intrinsics for
+// any instruction set without a flag.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SIMD_TARGET(instructionSet)
+#else
+#define SIMD_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#endif
+
+enum class SimdLevel
+{
+    NONE,
+    SSE4_2,
+    AVX2,
+};
+
+SimdLevel DetectSimdLevel()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool hasSse42 = (info[2] & (1 << 20)) != 0;
+    const bool hasOsXsave = (info[2] & (1 << 27)) != 0;
+
+    __cpuidex(info, 7, 0);
+    const bool hasAvx2 = (info[1] & (1 << 5)) != 0;
+
+    // The OS has to save the YMM registers too.
+    if (hasAvx2 && hasOsXsave && (_xgetbv(0) & 6) == 6)
+    {
+        return SimdLevel::AVX2;
+    }
+#else
+    __builtin_cpu_init();
+    const bool hasSse42 = __builtin_cpu_supports("sse4.2");
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::AVX2;
+    }
+#endif
+
+    return hasSse42 ? SimdLevel::SSE4_2 : SimdLevel::NONE;
+}
+
+SimdLevel GetSimdLevel()
+{
+    static const SimdLevel simdLevel = DetectSimdLevel();
+    return simdLevel;
+}
+
+// GetPriceMatches four prices at a time; returns how many prices were compared.
+template <PriceComparison comparison>
+SIMD_TARGET("avx2")
+int GetPriceMatchesAvx2(
+    const std::vector<FixedPrice>& prices, FixedPrice quote, IntervalMask& matches
+)
+{
+    const int size = static_cast<int>(prices.size());
+    int i = 0;
+
+    const __m256i quotes = _mm256_set1_epi64x(quote.ticks);
+    const __m256i allOnes = _mm256_set1_epi64x(-1);
+
+    for (; i + 4 <= size; i += 4)
+    {
+        const __m256i lanePrices =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&prices[i]));
+
+        __m256i isMatch;
+        if constexpr (comparison == PriceComparison::GREATER)
+        {
+            isMatch = _mm256_cmpgt_epi64(lanePrices, quotes);
+        }
+        else if constexpr (comparison == PriceComparison::LESS)
+        {
+            isMatch = _mm256_cmpgt_epi64(quotes, lanePrices);
+        }
+        else if constexpr (comparison == PriceComparison::LESS_EQUAL)
+        {
+            isMatch = _mm256_xor_si256(_mm256_cmpgt_epi64(lanePrices, quotes), allOnes);
+        }
+        else
+        {
+            isMatch = _mm256_xor_si256(_mm256_cmpgt_epi64(quotes, lanePrices), allOnes);
+        }
+
+        const uint64_t laneMask = _mm256_movemask_pd(_mm256_castsi256_pd(isMatch));
+        matches.words[i >> 6] |= laneMask << (i & 63);
+    }
+
+    return i;
+}
+
+// GetPriceMatches two prices at a time; returns how many prices were compared.
+template <PriceComparison comparison>
+SIMD_TARGET("sse4.2")
+int GetPriceMatchesSse42(
+    const std::vector<FixedPrice>& prices, FixedPrice quote, IntervalMask& matches
+)
+{
+    const int size = static_cast<int>(prices.size());
+    int i = 0;
+
+    const __m128i quotes = _mm_set1_epi64x(quote.ticks);
+    const __m128i allOnes = _mm_set1_epi64x(-1);
+
+    for (; i + 2 <= size; i += 2)
+    {
+        const __m128i lanePrices =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&prices[i]));
+
+        __m128i isMatch;
+        if constexpr (comparison == PriceComparison::GREATER)
+        {
+            isMatch = _mm_cmpgt_epi64(lanePrices, quotes);
+        }
+        else if constexpr (comparison == PriceComparison::LESS)
+        {
+            isMatch = _mm_cmpgt_epi64(quotes, lanePrices);
+        }
+        else if constexpr (comparison == PriceComparison::LESS_EQUAL)
+        {
+            isMatch = _mm_xor_si128(_mm_cmpgt_epi64(lanePrices, quotes), allOnes);
+        }
+        else
+        {
+            isMatch = _mm_xor_si128(_mm_cmpgt_epi64(quotes, lanePrices), allOnes);
+        }
+
+        const uint64_t laneMask = _mm_movemask_pd(_mm_castsi128_pd(isMatch));
+        matches.words[i >> 6] |= laneMask << (i & 63);
+    }
+
+    return i;
+}
+#endif
+
+// Sets `matches` to the intervals whose price compares to `quote` as `comparison`.
+template <PriceComparison comparison>
+void GetPriceMatches(
+    const std::vector<FixedPrice>& prices, FixedPrice quote, IntervalMask& matches
+)
+{
+    static_assert(sizeof(FixedPrice) == sizeof(int64_t));
+
+    matches.Clear();
+
+    const int size = static_cast<int>(prices.size());
+    int i = 0;
+
+#if defined(HAS_X86_SIMD)
+    const SimdLevel simdLevel = GetSimdLevel();
+    if (simdLevel == SimdLevel::AVX2)
+    {
+        i = GetPriceMatchesAvx2<comparison>(prices, quote, matches);
+    }
+    else if (simdLevel == SimdLevel::SSE4_2)
+    {
+        i = GetPriceMatchesSse42<comparison>(prices, quote, matches);
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        if (IsPriceMatch<comparison>(prices[i], quote))
+        {
+            matches.Set(i);
+        }
+    }
+}
+
+// Calls onWord(w, matches) with the bits of word w whose price compares to `quote`
+// as `comparison`. Indexed prices match a prefix or suffix of the ladder, found by
+// CountPricesAbove, and only the words overlapping it are visited; otherwise every
+// price is compared.
+template <PriceComparison comparison, typename OnWord>
+void ForEachPriceMatchWord(
+    IntervalLadder& ladder,
+    const std::vector<FixedPrice>& basePrices,
+    const PriceIndex& index,
+    FixedPrice quote,
+    OnWord&& onWord
+)
+{
+    // base + offset vs quote is base vs quote - offset, exactly, in integer ticks.
+    const FixedPrice baseQuote = quote - ladder.priceOffset;
+
+    if (!index.isDescending)
+    {
+        auto& priceMatches = ladder.priceMatches;
+        GetPriceMatches<comparison>(basePrices, baseQuote, priceMatches);
+
+        for (int w = 0; w < priceMatches.GetWordCount(); ++w)
+        {
+            onWord(w, priceMatches.words[w]);
+        }
+
+        return;
+    }
+
+    const int size = ladder.size();
+
+    int begin = 0;
+    int end = size;
+    if constexpr (comparison == PriceComparison::GREATER)
+    {
+        end = CountPricesAbove(index, basePrices, baseQuote, false);
+    }
+    else if constexpr (comparison == PriceComparison::GREATER_EQUAL)
+    {
+        end = CountPricesAbove(index, basePrices, baseQuote, true);
+    }
+    else if constexpr (comparison == PriceComparison::LESS)
+    {
+        begin = CountPricesAbove(index, basePrices, baseQuote, true);
+    }
+    else
+    {
+        begin = CountPricesAbove(index, basePrices, baseQuote, false);
+    }
+
+    if (begin >= end)
+    {
+        return;
+    }
+
+    for (int w = begin >> 6; w <= (end - 1) >> 6; ++w)
+    {
+        onWord(w, GetRangeWord(w, begin, end));
+    }
+}
+
+bool MarkLadderCrossings(IntervalLadder& ladder, FixedPrice ask, FixedPrice bid)
+{
+    uint64_t crossed = 0;
+
+    ForEachPriceMatchWord<PriceComparison::GREATER>(
+        ladder,
+        ladder.buyBasePrices,
+        ladder.buyPriceIndex,
+        ask,
+        [&](int w, uint64_t matches)
+        {
+            const uint64_t newlyCrossed =
+                matches & ladder.buyActive.words[w] & ~ladder.buyCrossed.words[w];
+            ladder.buyCrossed.words[w] |= newlyCrossed;
+            crossed |= newlyCrossed;
+        }
+    );
+
+    ForEachPriceMatchWord<PriceComparison::LESS>(
+        ladder,
+        ladder.sellBasePrices,
+        ladder.sellPriceIndex,
+        bid,
+        [&](int w, uint64_t matches)
+        {
+            const uint64_t newlyCrossed =
+                matches & ladder.sellActive.words[w] & ~ladder.sellCrossed.words[w];
+            ladder.sellCrossed.words[w] |= newlyCrossed;
+            crossed |= newlyCrossed;
+        }
+    );
+
+    return crossed != 0;
+}
+
+void GetExecutableBuyIntervals(
+    IntervalLadder& ladder, FixedPrice ask, IntervalMask& executable
+)
+{
+    executable.Clear();
+
+    ForEachPriceMatchWord<PriceComparison::LESS_EQUAL>(
+        ladder,
+        ladder.buyBasePrices,
+        ladder.buyPriceIndex,
+        ask,
+        [&](int w, uint64_t matches)
+        {
+            executable.words[w] =
+                matches & ladder.buyActive.words[w] & ladder.buyCrossed.words[w];
+        }
+    );
+}
+
+void GetExecutableSellIntervals(
+    IntervalLadder& ladder, FixedPrice bid, IntervalMask& executable
+)
+{
+    executable.Clear();
+
+    ForEachPriceMatchWord<PriceComparison::GREATER_EQUAL>(
+        ladder,
+        ladder.sellBasePrices,
+        ladder.sellPriceIndex,
+        bid,
+        [&](int w, uint64_t matches)
+        {
+            executable.words[w] =
+                matches & ladder.sellActive.words[w] & ladder.sellCrossed.words[w];
+        }
+    );
+}
+
+void ShiftLadderPrices(IntervalLadder& ladder, FixedPrice shift)
+{
+    ladder.priceOffset += shift;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include "types.hpp"
+
+inline FixedPrice GetBuyPrice(const IntervalLadder& ladder, int index)
+{
+    return ladder.buyBasePrices[index] + ladder.priceOffset;
+}
+
+inline FixedPrice GetSellPrice(const IntervalLadder& ladder, int index)
+{
+    return ladder.sellBasePrices[index] + ladder.priceOffset;
+}
+
+IntervalLadder GetIntervalLadder(const std::vector<SmoothingInterval>& intervals);
+
+std::vector<SmoothingInterval> GetSmoothingIntervals(const IntervalLadder& ladder);
+
+// Price lookups over the ladder. Indexed price arrays (see PriceIndex) are resolved
+// to a range of levels without touching the prices; otherwise the compares run as
+// AVX2 or SSE4.2 compare-and-mask kernels, picked once at run time from what the CPU
+// supports, and as a scalar loop on CPUs with neither. The flag tests are bitset
+// operations.
+
+// Marks BUY crossed where BUY is active and ask < BUY.price, and SELL crossed where
+// SELL is active and bid > SELL.price. Returns whether anything was marked.
+bool MarkLadderCrossings(IntervalLadder& ladder, FixedPrice ask, FixedPrice bid);
+
+// Sets `executable` to the intervals whose BUY is active, crossed and
+// BUY.price <= ask.
+void GetExecutableBuyIntervals(
+    IntervalLadder& ladder, FixedPrice ask, IntervalMask& executable
+);
+
+// Sets `executable` to the intervals whose SELL is active, crossed and
+// SELL.price >= bid.
+void GetExecutableSellIntervals(
+    IntervalLadder& ladder, FixedPrice bid, IntervalMask& executable
+);
+
+// Moves every BUY and SELL level by `shift`, in constant time.
+void ShiftLadderPrices(IntervalLadder& ladder, FixedPrice shift);
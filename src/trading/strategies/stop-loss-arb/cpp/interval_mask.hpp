@@ -0,0 +1,145 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// Template argument for the mask operations below when the number of words is only
+// known at run time. Kernels specialized for a ladder size pass the word count
+// instead, so the word loops have a constant trip count and unroll.
+const int kDynamicNumWords = 0;
+
+// One bit per ladder level, 64 levels per word. Bits past the ladder size are always
+// zero, so whole-word operations never report levels that do not exist.
+struct IntervalMask
+{
+    std::vector<uint64_t> words;
+
+    static int GetNumWords(int numIntervals) { return (numIntervals + 63) / 64; }
+
+    template <int kNumWords = kDynamicNumWords>
+    int GetWordCount() const
+    {
+        if constexpr (kNumWords == kDynamicNumWords)
+        {
+            return static_cast<int>(words.size());
+        }
+        else
+        {
+            return kNumWords;
+        }
+    }
+
+    void Resize(int numIntervals) { words.assign(GetNumWords(numIntervals), 0); }
+
+    void Clear()
+    {
+        for (auto& word : words)
+        {
+            word = 0;
+        }
+    }
+
+    bool Test(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+    void Set(int i) { words[i >> 6] |= uint64_t{1} << (i & 63); }
+
+    void Reset(int i) { words[i >> 6] &= ~(uint64_t{1} << (i & 63)); }
+
+    template <int kNumWords = kDynamicNumWords>
+    bool Any() const
+    {
+        for (int w = 0; w < GetWordCount<kNumWords>(); ++w)
+        {
+            if (words[w] != 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    template <int kNumWords = kDynamicNumWords>
+    int Count() const
+    {
+        int count = 0;
+        for (int w = 0; w < GetWordCount<kNumWords>(); ++w)
+        {
+            count += std::popcount(words[w]);
+        }
+
+        return count;
+    }
+
+    // Lowest set index, or -1 if none.
+    int First() const
+    {
+        for (int w = 0; w < GetWordCount(); ++w)
+        {
+            if (words[w] != 0)
+            {
+                return w * 64 + std::countr_zero(words[w]);
+            }
+        }
+
+        return -1;
+    }
+
+    // Highest set index, or -1 if none.
+    int Last() const
+    {
+        for (int w = static_cast<int>(words.size()) - 1; w >= 0; --w)
+        {
+            if (words[w] != 0)
+            {
+                return w * 64 + 63 - std::countl_zero(words[w]);
+            }
+        }
+
+        return -1;
+    }
+
+    // Calls function(i) for every set index, lowest first.
+    template <int kNumWords = kDynamicNumWords, typename Function>
+    void ForEach(Function&& function) const
+    {
+        for (int w = 0; w < GetWordCount<kNumWords>(); ++w)
+        {
+            for (uint64_t word = words[w]; word != 0; word &= word - 1)
+            {
+                function(w * 64 + std::countr_zero(word));
+            }
+        }
+    }
+
+    // Calls function(i) for every set index, highest first.
+    template <int kNumWords = kDynamicNumWords, typename Function>
+    void ForEachReverse(Function&& function) const
+    {
+        for (int w = GetWordCount<kNumWords>() - 1; w >= 0; --w)
+        {
+            for (uint64_t word = words[w]; word != 0;)
+            {
+                const int bit = 63 - std::countl_zero(word);
+                function(w * 64 + bit);
+                word &= ~(uint64_t{1} << bit);
+            }
+        }
+    }
+};
+
+// The bits of word `w` that fall in the index range [begin, end).
+inline uint64_t GetRangeWord(int w, int begin, int end)
+{
+    const int wordBegin = w * 64;
+    const int from = begin > wordBegin ? begin - wordBegin : 0;
+    const int to = end < wordBegin + 64 ? end - wordBegin : 64;
+    if (from >= to)
+    {
+        return 0;
+    }
+
+    const uint64_t upTo = to == 64 ? ~uint64_t{0} : (uint64_t{1} << to) - 1;
+    return upTo & ~((uint64_t{1} << from) - 1);
+}
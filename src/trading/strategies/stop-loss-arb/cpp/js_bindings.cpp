@@ -1,7 +1,34 @@
 #include "js_bindings.hpp"
 
+#include <cmath>
+#include <format>
+#include <optional>
+
+#include "interval_ladder.hpp"
+#include "timestamp.hpp"
+
 using namespace std;
 
+// getFullStockState seeds boughtAtPrice/soldAtPrice with NaN, which has no FixedPrice
+// representation, so NaN is bound as "no price" the same way null is.
+std::optional<FixedPrice> GetOptionalFixedPrice(
+    const JS::Object& js_object, const std::string& key
+)
+{
+    if (!js_object.Has(key) || js_object.Get(key).IsNull())
+    {
+        return std::nullopt;
+    }
+
+    const double value = js_object.Get(key).As<JS::Number>().DoubleValue();
+    if (std::isnan(value))
+    {
+        return std::nullopt;
+    }
+
+    return FixedPrice::FromDouble(value);
+}
+
 std::vector<std::unordered_map<std::string, StockState>>
 BindJsStatesListToCppStatesList(const JS::Array& js_states_list)
 {
@@ -41,28 +68,40 @@ std::unordered_map<std::string, StockState> BindJsStatesToCppStates(
         cpp_stock_state.brokerageId =
             js_stock_state.Get("brokerageId").As<JS::String>().Utf8Value();
 
-        cpp_stock_state.brokerageTradingCostPerShare =
-            GetDecimal(js_stock_state.Get("brokerageTradingCostPerShare")
-                           .As<JS::Number>()
-                           .DoubleValue());
+        cpp_stock_state.brokerageTradingCostPerShare = FixedPrice::FromDouble(
+            js_stock_state.Get("brokerageTradingCostPerShare")
+                .As<JS::Number>()
+                .DoubleValue()
+        );
 
         cpp_stock_state.sharesPerInterval =
             js_stock_state.Get("sharesPerInterval").As<JS::Number>().Int32Value();
 
-        cpp_stock_state.intervalProfit = GetDecimal(
+        cpp_stock_state.intervalProfit = FixedPrice::FromDouble(
             js_stock_state.Get("intervalProfit").As<JS::Number>().DoubleValue()
         );
 
-        cpp_stock_state.initialPrice =
-            GetDecimal(js_stock_state.Get("initialPrice").As<JS::Number>().DoubleValue()
+        cpp_stock_state.initialPrice = FixedPrice::FromDouble(
+            js_stock_state.Get("initialPrice").As<JS::Number>().DoubleValue()
+        );
+        if (cpp_stock_state.initialPrice <= FixedPrice{})
+        {
+            throw exception(
+                format(
+                    "Invalid initialPrice for {}: {}",
+                    stock,
+                    cpp_stock_state.initialPrice.ToDouble()
+                )
+                    .c_str()
             );
+        }
 
         cpp_stock_state.shiftIntervalsFromInitialPrice =
             js_stock_state.Get("shiftIntervalsFromInitialPrice")
                 .As<JS::Number>()
                 .Int32Value();
 
-        cpp_stock_state.spaceBetweenIntervals = GetDecimal(
+        cpp_stock_state.spaceBetweenIntervals = FixedPrice::FromDouble(
             js_stock_state.Get("spaceBetweenIntervals").As<JS::Number>().DoubleValue()
         );
 
@@ -75,32 +114,39 @@ std::unordered_map<std::string, StockState> BindJsStatesToCppStates(
         cpp_stock_state.targetPosition =
             js_stock_state.Get("targetPosition").As<JS::Number>().Int32Value();
 
-        cpp_stock_state.realizedPnL =
-            GetDecimal(js_stock_state.Get("realizedPnL").As<JS::Number>().DoubleValue()
-            );
+        cpp_stock_state.realizedPnL = FixedPrice::FromDouble(
+            js_stock_state.Get("realizedPnL").As<JS::Number>().DoubleValue()
+        );
 
-        cpp_stock_state.exitPnL =
-            GetDecimal(js_stock_state.Get("exitPnL").As<JS::Number>().DoubleValue());
+        cpp_stock_state.exitPnL = FixedPrice::FromDouble(
+            js_stock_state.Get("exitPnL").As<JS::Number>().DoubleValue()
+        );
 
-        cpp_stock_state.exitPnLAsPercentage = GetDecimal(
+        cpp_stock_state.exitPnLAsPercentage = FixedPrice::FromDouble(
             js_stock_state.Get("exitPnLAsPercentage").As<JS::Number>().DoubleValue()
         );
 
-        cpp_stock_state.maxMovingProfitAsPercentage =
-            GetDecimal(js_stock_state.Get("maxMovingProfitAsPercentage")
-                           .As<JS::Number>()
-                           .DoubleValue());
+        cpp_stock_state.maxMovingProfitAsPercentage = FixedPrice::FromDouble(
+            js_stock_state.Get("maxMovingProfitAsPercentage")
+                .As<JS::Number>()
+                .DoubleValue()
+        );
+
+        cpp_stock_state.maxMovingLossAsPercentage = FixedPrice::FromDouble(
+            js_stock_state.Get("maxMovingLossAsPercentage")
+                .As<JS::Number>()
+                .DoubleValue()
+        );
 
-        cpp_stock_state.maxMovingLossAsPercentage =
-            GetDecimal(js_stock_state.Get("maxMovingLossAsPercentage")
-                           .As<JS::Number>()
-                           .DoubleValue());
+        cpp_stock_state.lastAsk = FixedPrice::FromDouble(
+            js_stock_state.Get("lastAsk").As<JS::Number>().DoubleValue()
+        );
 
-        cpp_stock_state.lastAsk =
-            GetDecimal(js_stock_state.Get("lastAsk").As<JS::Number>().DoubleValue());
+        cpp_stock_state.lastBid = FixedPrice::FromDouble(
+            js_stock_state.Get("lastBid").As<JS::Number>().DoubleValue()
+        );
 
-        cpp_stock_state.lastBid =
-            GetDecimal(js_stock_state.Get("lastBid").As<JS::Number>().DoubleValue());
+        vector<SmoothingInterval> cpp_intervals;
 
         JS::Array js_intervals = js_stock_state.Get("intervals").As<JS::Array>();
         for (int j = 0; j < js_intervals.Length(); ++j)
@@ -119,42 +165,45 @@ std::unordered_map<std::string, StockState> BindJsStatesToCppStates(
             cpp_interval.SELL.active = js_sell.Get("active").As<JS::Boolean>().Value();
             cpp_interval.SELL.crossed =
                 js_sell.Get("crossed").As<JS::Boolean>().Value();
-            cpp_interval.SELL.price =
-                GetDecimal(js_sell.Get("price").As<JS::Number>().DoubleValue());
+            cpp_interval.SELL.price = FixedPrice::FromDouble(
+                js_sell.Get("price").As<JS::Number>().DoubleValue()
+            );
 
-            if (js_sell.Has("boughtAtPrice") && !js_sell.Get("boughtAtPrice").IsNull())
-            {
-                cpp_interval.SELL.boughtAtPrice = GetDecimal(
-                    js_sell.Get("boughtAtPrice").As<JS::Number>().DoubleValue()
-                );
-            }
+            cpp_interval.SELL.boughtAtPrice =
+                GetOptionalFixedPrice(js_sell, "boughtAtPrice");
 
             JS::Object js_buy = js_interval.Get("BUY").As<JS::Object>();
             cpp_interval.BUY.active = js_buy.Get("active").As<JS::Boolean>().Value();
             cpp_interval.BUY.crossed = js_buy.Get("crossed").As<JS::Boolean>().Value();
-            cpp_interval.BUY.price =
-                GetDecimal(js_buy.Get("price").As<JS::Number>().DoubleValue());
+            cpp_interval.BUY.price = FixedPrice::FromDouble(
+                js_buy.Get("price").As<JS::Number>().DoubleValue()
+            );
 
-            if (js_buy.Has("soldAtPrice") && !js_buy.Get("soldAtPrice").IsNull())
-            {
-                cpp_interval.BUY.soldAtPrice =
-                    GetDecimal(js_buy.Get("soldAtPrice").As<JS::Number>().DoubleValue()
-                    );
-            }
+            cpp_interval.BUY.soldAtPrice = GetOptionalFixedPrice(js_buy, "soldAtPrice");
 
-            cpp_stock_state.intervals.push_back(cpp_interval);
+            cpp_intervals.push_back(cpp_interval);
         }
 
+        cpp_stock_state.intervals = GetIntervalLadder(cpp_intervals);
+
         JS::Array js_tradingLogs = js_stock_state.Get("tradingLogs").As<JS::Array>();
         for (int k = 0; k < js_tradingLogs.Length(); ++k)
         {
             JS::Object js_log = js_tradingLogs.Get(k).As<JS::Object>();
             TradingLog cpp_log;
 
-            cpp_log.timeStamp = js_log.Get("timeStamp").As<JS::String>().Utf8Value();
+            const string timeStamp =
+                js_log.Get("timeStamp").As<JS::String>().Utf8Value();
+            if (!TryParseEasternTimestamp(timeStamp, cpp_log.timeStamp))
+            {
+                throw exception(
+                    format("Invalid trading log timeStamp: \"{}\"", timeStamp).c_str()
+                );
+            }
             cpp_log.action = js_log.Get("action").As<JS::String>().Utf8Value();
-            cpp_log.price =
-                GetDecimal(js_log.Get("price").As<JS::Number>().DoubleValue());
+            cpp_log.price = FixedPrice::FromDouble(
+                js_log.Get("price").As<JS::Number>().DoubleValue()
+            );
             cpp_log.previousPosition =
                 js_log.Get("previousPosition").As<JS::Number>().Int32Value();
             cpp_log.newPosition =
@@ -190,7 +239,7 @@ JS::Object BindCppStatesToJsStates(
         js_state.Set(
             "brokerageTradingCostPerShare",
             JS::Number::New(
-                env, cpp_state.brokerageTradingCostPerShare.convert_to<double>()
+                env, cpp_state.brokerageTradingCostPerShare.ToDouble()
             )
         );
 
@@ -200,12 +249,12 @@ JS::Object BindCppStatesToJsStates(
 
         js_state.Set(
             "intervalProfit",
-            JS::Number::New(env, cpp_state.intervalProfit.convert_to<double>())
+            JS::Number::New(env, cpp_state.intervalProfit.ToDouble())
         );
 
         js_state.Set(
             "initialPrice",
-            JS::Number::New(env, cpp_state.initialPrice.convert_to<double>())
+            JS::Number::New(env, cpp_state.initialPrice.ToDouble())
         );
 
         js_state.Set(
@@ -215,7 +264,7 @@ JS::Object BindCppStatesToJsStates(
 
         js_state.Set(
             "spaceBetweenIntervals",
-            JS::Number::New(env, cpp_state.spaceBetweenIntervals.convert_to<double>())
+            JS::Number::New(env, cpp_state.spaceBetweenIntervals.ToDouble())
         );
 
         js_state.Set("numContracts", JS::Number::New(env, cpp_state.numContracts));
@@ -226,44 +275,46 @@ JS::Object BindCppStatesToJsStates(
 
         js_state.Set(
             "realizedPnL",
-            JS::Number::New(env, cpp_state.realizedPnL.convert_to<double>())
+            JS::Number::New(env, cpp_state.realizedPnL.ToDouble())
         );
 
         js_state.Set(
-            "exitPnL", JS::Number::New(env, cpp_state.exitPnL.convert_to<double>())
+            "exitPnL", JS::Number::New(env, cpp_state.exitPnL.ToDouble())
         );
 
         js_state.Set(
             "exitPnLAsPercentage",
-            JS::Number::New(env, cpp_state.exitPnLAsPercentage.convert_to<double>())
+            JS::Number::New(env, cpp_state.exitPnLAsPercentage.ToDouble())
         );
 
         js_state.Set(
             "maxMovingProfitAsPercentage",
             JS::Number::New(
-                env, cpp_state.maxMovingProfitAsPercentage.convert_to<double>()
+                env, cpp_state.maxMovingProfitAsPercentage.ToDouble()
             )
         );
 
         js_state.Set(
             "maxMovingLossAsPercentage",
             JS::Number::New(
-                env, cpp_state.maxMovingLossAsPercentage.convert_to<double>()
+                env, cpp_state.maxMovingLossAsPercentage.ToDouble()
             )
         );
 
         js_state.Set(
-            "lastAsk", JS::Number::New(env, cpp_state.lastAsk.convert_to<double>())
+            "lastAsk", JS::Number::New(env, cpp_state.lastAsk.ToDouble())
         );
 
         js_state.Set(
-            "lastBid", JS::Number::New(env, cpp_state.lastBid.convert_to<double>())
+            "lastBid", JS::Number::New(env, cpp_state.lastBid.ToDouble())
         );
 
-        JS::Array js_intervals = JS::Array::New(env, cpp_state.intervals.size());
-        for (size_t i = 0; i < cpp_state.intervals.size(); ++i)
+        const auto cpp_intervals = GetSmoothingIntervals(cpp_state.intervals);
+
+        JS::Array js_intervals = JS::Array::New(env, cpp_intervals.size());
+        for (size_t i = 0; i < cpp_intervals.size(); ++i)
         {
-            const SmoothingInterval& cpp_interval = cpp_state.intervals[i];
+            const SmoothingInterval& cpp_interval = cpp_intervals[i];
             JS::Object js_interval = JS::Object::New(env);
 
             std::string typeStr =
@@ -279,7 +330,7 @@ JS::Object BindCppStatesToJsStates(
             js_sell.Set("crossed", JS::Boolean::New(env, cpp_interval.SELL.crossed));
             js_sell.Set(
                 "price",
-                JS::Number::New(env, cpp_interval.SELL.price.convert_to<double>())
+                JS::Number::New(env, cpp_interval.SELL.price.ToDouble())
             );
 
             if (cpp_interval.SELL.boughtAtPrice.has_value())
@@ -288,7 +339,7 @@ JS::Object BindCppStatesToJsStates(
                     "boughtAtPrice",
                     JS::Number::New(
                         env,
-                        cpp_interval.SELL.boughtAtPrice.value().convert_to<double>()
+                        cpp_interval.SELL.boughtAtPrice.value().ToDouble()
                     )
                 );
             }
@@ -304,7 +355,7 @@ JS::Object BindCppStatesToJsStates(
             js_buy.Set("crossed", JS::Boolean::New(env, cpp_interval.BUY.crossed));
             js_buy.Set(
                 "price",
-                JS::Number::New(env, cpp_interval.BUY.price.convert_to<double>())
+                JS::Number::New(env, cpp_interval.BUY.price.ToDouble())
             );
 
             if (cpp_interval.BUY.soldAtPrice.has_value())
@@ -312,7 +363,7 @@ JS::Object BindCppStatesToJsStates(
                 js_buy.Set(
                     "soldAtPrice",
                     JS::Number::New(
-                        env, cpp_interval.BUY.soldAtPrice.value().convert_to<double>()
+                        env, cpp_interval.BUY.soldAtPrice.value().ToDouble()
                     )
                 );
             }
@@ -333,10 +384,13 @@ JS::Object BindCppStatesToJsStates(
             const TradingLog& cpp_log = cpp_state.tradingLogs[j];
             JS::Object js_log = JS::Object::New(env);
 
-            js_log.Set("timeStamp", JS::String::New(env, cpp_log.timeStamp));
+            js_log.Set(
+                "timeStamp",
+                JS::String::New(env, FormatEasternTimestamp(cpp_log.timeStamp))
+            );
             js_log.Set("action", JS::String::New(env, cpp_log.action));
             js_log.Set(
-                "price", JS::Number::New(env, cpp_log.price.convert_to<double>())
+                "price", JS::Number::New(env, cpp_log.price.ToDouble())
             );
             js_log.Set(
                 "previousPosition", JS::Number::New(env, cpp_log.previousPosition)
@@ -0,0 +1,366 @@
+#include "monte_carlo.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <mutex>
+#include <span>
+
+#include "interval_ladder.hpp"
+#include "price_simulator.hpp"
+#include "simulate_day.hpp"
+#include "work_stealing_pool.hpp"
+
+using namespace std;
+
+const int kDefaultMonteCarloPaths = 10000;
+const int kDefaultMonteCarloSteps = 22200;
+const int kPathsPerTask = 64;
+
+const double kLowestPercentage = -100;
+const double kHighestPercentage = 100;
+const int kNumPercentageBins = 4000;
+const int kMaxNumTickBins = 1000;
+
+bool IsMonteCarlo()
+{
+    static const bool isMonteCarlo = IsTruthyEnv("MONTE_CARLO");
+    return isMonteCarlo;
+}
+
+int GetPositiveIntEnv(const char* envName, int defaultValue)
+{
+    const char* valueStr = getenv(envName);
+    if (valueStr == nullptr)
+    {
+        return defaultValue;
+    }
+
+    char* end = nullptr;
+    const long value = strtol(valueStr, &end, 10);
+    if (end == valueStr || *end != '\0' || value <= 0)
+    {
+        return defaultValue;
+    }
+
+    return static_cast<int>(value);
+}
+
+OutcomeHistogram MakeOutcomeHistogram(double lowest, double highest, int numBins)
+{
+    OutcomeHistogram histogram;
+    histogram.lowest = lowest;
+    histogram.binWidth = (highest - lowest) / numBins;
+    histogram.counts.assign(numBins, 0);
+
+    return histogram;
+}
+
+void AddToHistogram(OutcomeHistogram& histogram, FixedPrice exactValue)
+{
+    const double value = exactValue.ToDouble();
+
+    histogram.numValues++;
+    histogram.sum += exactValue;
+    histogram.min = min(histogram.min, value);
+    histogram.max = max(histogram.max, value);
+
+    const double bin = floor((value - histogram.lowest) / histogram.binWidth);
+    if (bin < 0)
+    {
+        histogram.numBelow++;
+    }
+    else if (bin >= histogram.counts.size())
+    {
+        histogram.numAbove++;
+    }
+    else
+    {
+        histogram.counts[static_cast<size_t>(bin)]++;
+    }
+}
+
+void MergeHistogram(OutcomeHistogram& histogram, const OutcomeHistogram& other)
+{
+    if (other.counts.size() != histogram.counts.size() ||
+        other.lowest != histogram.lowest || other.binWidth != histogram.binWidth)
+    {
+        throw exception("Cannot merge histograms with different bins");
+    }
+
+    for (size_t i = 0; i < histogram.counts.size(); ++i)
+    {
+        histogram.counts[i] += other.counts[i];
+    }
+
+    histogram.numBelow += other.numBelow;
+    histogram.numAbove += other.numAbove;
+    histogram.numValues += other.numValues;
+    histogram.sum += other.sum;
+    histogram.min = min(histogram.min, other.min);
+    histogram.max = max(histogram.max, other.max);
+}
+
+double GetHistogramQuantile(const OutcomeHistogram& histogram, double quantile)
+{
+    if (histogram.numValues == 0)
+    {
+        return nan("");
+    }
+
+    const double rank = quantile * histogram.numValues;
+
+    double numAtOrBelow = histogram.numBelow;
+    if (rank <= numAtOrBelow)
+    {
+        return histogram.min;
+    }
+
+    for (size_t i = 0; i < histogram.counts.size(); ++i)
+    {
+        const uint64_t count = histogram.counts[i];
+        if (count > 0 && rank <= numAtOrBelow + count)
+        {
+            const double fraction = (rank - numAtOrBelow) / count;
+            const double value = histogram.lowest + histogram.binWidth * (i + fraction);
+
+            return clamp(value, histogram.min, histogram.max);
+        }
+
+        numAtOrBelow += count;
+    }
+
+    return histogram.max;
+}
+
+MonteCarloOutcomes MakeMonteCarloOutcomes(int numSteps)
+{
+    MonteCarloOutcomes outcomes;
+
+    outcomes.exitPnLAsPercentage =
+        MakeOutcomeHistogram(kLowestPercentage, kHighestPercentage, kNumPercentageBins);
+    outcomes.maxMovingProfitAsPercentage = outcomes.exitPnLAsPercentage;
+    outcomes.maxMovingLossAsPercentage = outcomes.exitPnLAsPercentage;
+    outcomes.ticksToBound =
+        MakeOutcomeHistogram(0, numSteps, min(numSteps, kMaxNumTickBins));
+
+    return outcomes;
+}
+
+void MergeMonteCarloOutcomes(
+    MonteCarloOutcomes& outcomes, const MonteCarloOutcomes& other
+)
+{
+    outcomes.numPaths += other.numPaths;
+
+    MergeHistogram(outcomes.exitPnLAsPercentage, other.exitPnLAsPercentage);
+    MergeHistogram(
+        outcomes.maxMovingProfitAsPercentage, other.maxMovingProfitAsPercentage
+    );
+    MergeHistogram(outcomes.maxMovingLossAsPercentage, other.maxMovingLossAsPercentage);
+    MergeHistogram(outcomes.ticksToBound, other.ticksToBound);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        outcomes.numReachedProfit[i] += other.numReachedProfit[i];
+    }
+}
+
+struct MonteCarloStockDay
+{
+    const string* stock;
+    const StockState* stockState;
+};
+
+// Runs paths [firstPath, firstPath + numPaths) of the stock-day into `outcomes`.
+void RunMonteCarloPaths(
+    const MonteCarloStockDay& stockDay,
+    uint64_t firstPath,
+    int numPaths,
+    int numSteps,
+    MonteCarloOutcomes& outcomes
+)
+{
+    const string& stock = *stockDay.stock;
+    const StockState& originalState = *stockDay.stockState;
+    const IntervalLadder& intervals = originalState.intervals;
+
+    // Past these the walk has left the ladder (see DebugRandomPrices).
+    const FixedPrice aboveTopSell =
+        GetSellPrice(intervals, 0) + originalState.spaceBetweenIntervals;
+    const FixedPrice belowBottomBuy = GetBuyPrice(intervals, intervals.size() - 1) -
+                                      originalState.spaceBetweenIntervals;
+
+    vector<Snapshot> snapshots(numSteps);
+
+    for (uint64_t path = firstPath; path < firstPath + numPaths; ++path)
+    {
+        StockState stockState = originalState;
+        // Walks start from the ladder's center rather than the debug loop's price.
+        SeedRandomWalk(stockState, stock, path);
+        stockState.randomWalk.price = originalState.initialPrice;
+
+        GetRandomSnapshots(stockState.randomWalk, snapshots);
+
+        const auto bound = find_if(
+            snapshots.begin(),
+            snapshots.end(),
+            [&](const Snapshot& snapshot)
+            { return snapshot.bid >= aboveTopSell || snapshot.ask <= belowBottomBuy; }
+        );
+
+        // The quote that leaves the ladder is still traded on.
+        const size_t numTicks =
+            bound == snapshots.end() ? snapshots.size() : bound - snapshots.begin() + 1;
+
+        const DayResult result = SimulateDay(
+            stock, stockState, span<const Snapshot>(snapshots.data(), numTicks), nullptr
+        );
+
+        outcomes.numPaths++;
+        AddToHistogram(outcomes.exitPnLAsPercentage, result.exitPnLAsPercentage);
+        AddToHistogram(
+            outcomes.maxMovingProfitAsPercentage, result.maxMovingProfitAsPercentage
+        );
+        AddToHistogram(
+            outcomes.maxMovingLossAsPercentage, result.maxMovingLossAsPercentage
+        );
+
+        if (bound != snapshots.end())
+        {
+            AddToHistogram(outcomes.ticksToBound, FixedPrice::FromInt(numTicks));
+        }
+
+        outcomes.numReachedProfit[0] += result.reached_1_percentage_profit;
+        outcomes.numReachedProfit[1] += result.reached_0_75_percentage_profit;
+        outcomes.numReachedProfit[2] += result.reached_0_5_percentage_profit;
+        outcomes.numReachedProfit[3] += result.reached_0_25_percentage_profit;
+    }
+}
+
+// All stock-days' paths go on the pool together, in tasks of kPathsPerTask. Each
+// task fills its own outcomes and merges them into its stock-day's when done.
+vector<MonteCarloOutcomes> RunMonteCarlo(
+    const vector<MonteCarloStockDay>& stockDays, int numPaths, int numSteps
+)
+{
+    const int numTasksPerDay = (numPaths + kPathsPerTask - 1) / kPathsPerTask;
+
+    vector<MonteCarloOutcomes> outcomes(
+        stockDays.size(), MakeMonteCarloOutcomes(numSteps)
+    );
+    vector<mutex> outcomesLocks(stockDays.size());
+
+    RunOnWorkerPool(
+        stockDays.size() * numTasksPerDay,
+        [&](size_t i)
+        {
+            const size_t day = i / numTasksPerDay;
+            const int firstPath = static_cast<int>(i % numTasksPerDay) * kPathsPerTask;
+
+            MonteCarloOutcomes taskOutcomes = MakeMonteCarloOutcomes(numSteps);
+            RunMonteCarloPaths(
+                stockDays[day],
+                firstPath,
+                min(kPathsPerTask, numPaths - firstPath),
+                numSteps,
+                taskOutcomes
+            );
+
+            lock_guard<mutex> guard(outcomesLocks[day]);
+            MergeMonteCarloOutcomes(outcomes[day], taskOutcomes);
+        }
+    );
+
+    return outcomes;
+}
+
+MonteCarloOutcomes RunMonteCarlo(
+    const std::string& stock, const StockState& stockState, int numPaths, int numSteps
+)
+{
+    return RunMonteCarlo({MonteCarloStockDay{&stock, &stockState}}, numPaths, numSteps)
+        .front();
+}
+
+string FormatQuantiles(const OutcomeHistogram& histogram)
+{
+    return format(
+        "p5 {:.3f} p25 {:.3f} p50 {:.3f} p75 {:.3f} p95 {:.3f}",
+        GetHistogramQuantile(histogram, 0.05),
+        GetHistogramQuantile(histogram, 0.25),
+        GetHistogramQuantile(histogram, 0.5),
+        GetHistogramQuantile(histogram, 0.75),
+        GetHistogramQuantile(histogram, 0.95)
+    );
+}
+
+void PrintMonteCarloOutcomes(
+    const MonteCarloStockDay& stockDay, const MonteCarloOutcomes& outcomes, int numSteps
+)
+{
+    const double numPaths = static_cast<double>(outcomes.numPaths);
+    const auto& reached = outcomes.numReachedProfit;
+
+    string message = format(
+        "Monte Carlo for {} on {}: {} paths of up to {} ticks",
+        *stockDay.stock,
+        stockDay.stockState->date,
+        outcomes.numPaths,
+        numSteps
+    );
+
+    message += format(
+        "\n    exit PnL %: {} (mean {:.3f})",
+        FormatQuantiles(outcomes.exitPnLAsPercentage),
+        outcomes.exitPnLAsPercentage.sum.ToDouble() / numPaths
+    );
+    message += format(
+        "\n    max moving profit %: {}",
+        FormatQuantiles(outcomes.maxMovingProfitAsPercentage)
+    );
+    message += format(
+        "\n    max moving loss %: {}",
+        FormatQuantiles(outcomes.maxMovingLossAsPercentage)
+    );
+    message += format(
+        "\n    reached profit: 1% {:.1f}%, 0.75% {:.1f}%, 0.5% {:.1f}%, 0.25% {:.1f}%",
+        100 * reached[0] / numPaths,
+        100 * reached[1] / numPaths,
+        100 * reached[2] / numPaths,
+        100 * reached[3] / numPaths
+    );
+    message += format(
+        "\n    left the ladder: {:.1f}% of paths, ticks to bound {}",
+        100 * outcomes.ticksToBound.numValues / numPaths,
+        FormatQuantiles(outcomes.ticksToBound)
+    );
+
+    Print(message);
+}
+
+void RunMonteCarloCpp(
+    const std::vector<std::unordered_map<std::string, StockState>>& states_list
+)
+{
+    const int numPaths =
+        GetPositiveIntEnv("MONTE_CARLO_PATHS", kDefaultMonteCarloPaths);
+    const int numSteps =
+        GetPositiveIntEnv("MONTE_CARLO_STEPS", kDefaultMonteCarloSteps);
+
+    vector<MonteCarloStockDay> stockDays;
+    for (const auto& states : states_list)
+    {
+        for (const auto& [stock, state] : states)
+        {
+            stockDays.push_back(MonteCarloStockDay{&stock, &state});
+        }
+    }
+
+    const auto outcomes = RunMonteCarlo(stockDays, numPaths, numSteps);
+
+    for (size_t i = 0; i < stockDays.size(); ++i)
+    {
+        PrintMonteCarloOutcomes(stockDays[i], outcomes[i], numSteps);
+    }
+}
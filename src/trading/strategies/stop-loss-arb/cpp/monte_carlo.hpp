@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+// MONTE_CARLO: JsStartStopLossArbCpp estimates each stock-day's outcome distribution
+// on random walks instead of backtesting it.
+bool IsMonteCarlo();
+
+// Equal-width bins over [lowest, lowest + binWidth * counts.size()), with values
+// outside counted apart. Histograms with the same bins merge by adding counts, so
+// each worker fills its own and they are combined once at the end. The sum is kept
+// in ticks, so merged totals are exact whichever order the workers finish in.
+struct OutcomeHistogram
+{
+    double lowest = 0;
+    double binWidth = 1;
+    std::vector<uint64_t> counts;
+    uint64_t numBelow = 0;
+    uint64_t numAbove = 0;
+    uint64_t numValues = 0;
+    FixedPrice sum;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+};
+
+OutcomeHistogram MakeOutcomeHistogram(double lowest, double highest, int numBins);
+
+void AddToHistogram(OutcomeHistogram& histogram, FixedPrice value);
+
+void MergeHistogram(OutcomeHistogram& histogram, const OutcomeHistogram& other);
+
+// The value `quantile` of the way up the sorted values, interpolated within its bin
+// and clamped to the observed range; NaN if the histogram is empty.
+double GetHistogramQuantile(const OutcomeHistogram& histogram, double quantile);
+
+struct MonteCarloOutcomes
+{
+    uint64_t numPaths = 0;
+    OutcomeHistogram exitPnLAsPercentage;
+    OutcomeHistogram maxMovingProfitAsPercentage;
+    OutcomeHistogram maxMovingLossAsPercentage;
+    // Ticks until the walk left the ladder, for the paths that did.
+    OutcomeHistogram ticksToBound;
+    // Paths that reached 1%, 0.75%, 0.5% and 0.25% profit.
+    uint64_t numReachedProfit[4] = {};
+};
+
+// `numPaths` independent walks of up to `numSteps` ticks from the stock's state, run
+// across the worker pool. A walk stops once a quote is a level spacing past the top
+// SELL or the bottom BUY of the starting ladder. Paths are RandomWalk paths of the
+// stock's key, so RANDOM_SEED replays a run.
+MonteCarloOutcomes RunMonteCarlo(
+    const std::string& stock, const StockState& stockState, int numPaths, int numSteps
+);
+
+// RunMonteCarlo for every stock-day, with MONTE_CARLO_PATHS paths (10000) of
+// MONTE_CARLO_STEPS ticks (22200, the 09:40-15:50 session in seconds), printing
+// each one's quantiles.
+void RunMonteCarloCpp(
+    const std::vector<std::unordered_map<std::string, StockState>>& states_list
+);
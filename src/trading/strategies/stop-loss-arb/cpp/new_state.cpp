@@ -0,0 +1,100 @@
+#include "new_state.hpp"
+
+#include <format>
+#include <vector>
+
+#include "interval_ladder.hpp"
+
+using namespace std;
+
+vector<SmoothingInterval> GetLongIntervalsAboveInitialPrice(const StockState& partial)
+{
+    vector<SmoothingInterval> intervals;
+    const int numIntervals = partial.targetPosition / partial.sharesPerInterval;
+
+    for (int index = numIntervals + 1; index >= 1; --index)
+    {
+        const FixedPrice sellPrice =
+            partial.initialPrice + partial.spaceBetweenIntervals *
+                                       (index + partial.shiftIntervalsFromInitialPrice);
+
+        SmoothingInterval interval{};
+        interval.type = IntervalType::LONG;
+        interval.positionLimit = partial.sharesPerInterval * index;
+        interval.SELL.active = false;
+        interval.SELL.crossed = false;
+        interval.SELL.price = sellPrice;
+        interval.BUY.active = true;
+        interval.BUY.crossed = true;
+        interval.BUY.price = sellPrice - partial.intervalProfit;
+
+        intervals.push_back(interval);
+    }
+
+    return intervals;
+}
+
+vector<SmoothingInterval> GetShortIntervalsBelowInitialPrice(const StockState& partial)
+{
+    vector<SmoothingInterval> intervals;
+    const int numIntervals = partial.targetPosition / partial.sharesPerInterval;
+
+    for (int index = 1; index <= numIntervals + 1; ++index)
+    {
+        const FixedPrice buyPrice =
+            partial.initialPrice - partial.spaceBetweenIntervals *
+                                       (index + partial.shiftIntervalsFromInitialPrice);
+
+        SmoothingInterval interval{};
+        interval.type = IntervalType::SHORT;
+        interval.positionLimit = -(partial.sharesPerInterval * index);
+        interval.SELL.active = true;
+        interval.SELL.crossed = true;
+        interval.SELL.price = buyPrice + partial.intervalProfit;
+        interval.BUY.active = false;
+        interval.BUY.crossed = false;
+        interval.BUY.price = buyPrice;
+
+        intervals.push_back(interval);
+    }
+
+    return intervals;
+}
+
+StockState GetFullStockState(const StockState& partial)
+{
+    if (partial.sharesPerInterval <= 0)
+    {
+        throw exception(
+            format("Invalid sharesPerInterval: {}", partial.sharesPerInterval).c_str()
+        );
+    }
+
+    if (partial.initialPrice <= FixedPrice{})
+    {
+        throw exception(
+            format("Invalid initialPrice: {}", partial.initialPrice.ToDouble()).c_str()
+        );
+    }
+
+    vector<SmoothingInterval> intervals = GetLongIntervalsAboveInitialPrice(partial);
+    const vector<SmoothingInterval> shortIntervals =
+        GetShortIntervalsBelowInitialPrice(partial);
+    intervals.insert(intervals.end(), shortIntervals.begin(), shortIntervals.end());
+
+    StockState state{};
+    state.date = partial.date;
+    state.brokerageId = partial.brokerageId;
+    state.brokerageTradingCostPerShare = partial.brokerageTradingCostPerShare;
+    state.targetPosition = partial.targetPosition;
+    state.sharesPerInterval = partial.sharesPerInterval;
+    state.spaceBetweenIntervals = partial.spaceBetweenIntervals;
+    state.intervalProfit = partial.intervalProfit;
+    state.numContracts = partial.numContracts;
+    state.initialPrice = partial.initialPrice;
+    state.shiftIntervalsFromInitialPrice = partial.shiftIntervalsFromInitialPrice;
+    state.isStaticIntervals = partial.isStaticIntervals;
+    state.intervals = GetIntervalLadder(intervals);
+
+    return state;
+}
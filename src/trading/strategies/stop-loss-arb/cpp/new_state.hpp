@@ -0,0 +1,9 @@
+#pragma once
+
+#include "types.hpp"
+
+// Native getFullStockState (new-state.ts): a fresh day's state with the settings of
+// `partial` (date, brokerage, costs, initial price, sizes, spacing, profit) and its
+// ladder built from them. targetPosition / sharesPerInterval + 1 LONG levels sit
+// above the initial price and as many SHORT levels below it.
+StockState GetFullStockState(const StockState& partial);
@@ -1,5 +1,16 @@
+#include "dataset_manifest.hpp"
 #include "js_bindings.hpp"
+#include "monte_carlo.hpp"
+#include "numeric_conversions.hpp"
+#include "numeric_conversions_benchmark.hpp"
+#include "parameter_sweep.hpp"
+#include "parity.hpp"
+#include "price_simulator.hpp"
+#include "raw_quotes.hpp"
+#include "snapshot_codec.hpp"
+#include "snapshot_file.hpp"
 #include "start.hpp"
+#include "timestamp.hpp"
 
 #define GET_SYMBOL_NAME(symbol) #symbol
 
@@ -22,9 +33,316 @@ void JsStartStopLossArbCpp(const JS::CallbackInfo& info)
 
     auto cpp_states_list = BindJsStatesListToCppStatesList(js_states_list);
 
+    if (IsDecimalParity())
+    {
+        RunDecimalParityCpp(cpp_states_list);
+        return;
+    }
+
+    if (IsMonteCarlo())
+    {
+        RunMonteCarloCpp(cpp_states_list);
+        return;
+    }
+
     StartStopLossArbCpp(cpp_states_list);
 }
 
+void JsRunNumericConversionsBenchmark(const JS::CallbackInfo& info)
+{
+    const int num_conversions =
+        info.Length() > 0 ? info[0].As<JS::Number>().Int32Value() : 1'000'000;
+
+    RunNumericConversionsBenchmark(num_conversions);
+}
+
+JS::Value JsConvertSnapshotJsonFilesToBinary(const JS::CallbackInfo& info)
+{
+    JS::Env env = info.Env();
+
+    const string root = info.Length() > 0 && info[0].IsString()
+                            ? info[0].As<JS::String>().Utf8Value()
+                            : GetHistoricalDataRootPath();
+
+    const bool isCompressed = info.Length() > 1 && info[1].As<JS::Boolean>().Value();
+
+    return JS::Number::New(env, ConvertSnapshotJsonFilesToBinary(root, isCompressed));
+}
+
+JS::Value JsConvertRawQuoteFilesToSnapshots(const JS::CallbackInfo& info)
+{
+    JS::Env env = info.Env();
+
+    const string raw_root = info[0].As<JS::String>().Utf8Value();
+    const string snapshot_root = info.Length() > 1 && info[1].IsString()
+                                     ? info[1].As<JS::String>().Utf8Value()
+                                     : GetHistoricalDataRootPath();
+    const bool isCompressed = info.Length() > 2 && info[2].As<JS::Boolean>().Value();
+
+    return JS::Number::New(
+        env, ConvertRawQuoteFilesToSnapshots(raw_root, snapshot_root, isCompressed)
+    );
+}
+
+JS::Value JsUpdateDatasetManifest(const JS::CallbackInfo& info)
+{
+    JS::Env env = info.Env();
+
+    const string root = info.Length() > 0 && info[0].IsString()
+                            ? info[0].As<JS::String>().Utf8Value()
+                            : GetHistoricalDataRootPath();
+
+    return JS::Number::New(env, UpdateDatasetManifest(root));
+}
+
+// The date's days from the dataset manifest as [{ticker, numSnapshots, firstAsk,
+// firstBid, high, low}]; empty if the manifest does not have the date.
+JS::Value JsGetDatasetManifestEntriesOnDate(const JS::CallbackInfo& info)
+{
+    JS::Env env = info.Env();
+
+    const string date = info[0].As<JS::String>().Utf8Value();
+    const auto entries = GetDatasetManifestEntriesOnDate(date);
+
+    JS::Array result = JS::Array::New(env, entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const DatasetManifestEntry& entry = *entries[i];
+
+        JS::Object day = JS::Object::New(env);
+        day.Set("ticker", JS::String::New(env, entry.ticker));
+        day.Set(
+            "numSnapshots",
+            JS::Number::New(env, static_cast<double>(entry.numSnapshots))
+        );
+        day.Set("firstAsk", JS::Number::New(env, entry.firstAsk.ToDouble()));
+        day.Set("firstBid", JS::Number::New(env, entry.firstBid.ToDouble()));
+        day.Set("high", JS::Number::New(env, entry.high.ToDouble()));
+        day.Set("low", JS::Number::New(env, entry.low.ToDouble()));
+
+        result.Set(static_cast<uint32_t>(i), day);
+    }
+
+    return result;
+}
+
+template <typename T, typename Convert>
+vector<T> GetJsArray(const JS::Object& js_object, const string& key, Convert convert)
+{
+    const JS::Array js_array = js_object.Get(key).As<JS::Array>();
+
+    vector<T> values;
+    for (uint32_t i = 0; i < js_array.Length(); ++i)
+    {
+        values.push_back(convert(js_array.Get(i).As<JS::Number>()));
+    }
+
+    return values;
+}
+
+ParameterGrid BindJsParameterGrid(const JS::Object& js_grid)
+{
+    const auto toPrice = [](const JS::Number& value)
+    { return FixedPrice::FromDouble(value.DoubleValue()); };
+    const auto toInt = [](const JS::Number& value) { return value.Int32Value(); };
+
+    ParameterGrid grid;
+    grid.spaceBetweenIntervals =
+        GetJsArray<FixedPrice>(js_grid, "spaceBetweenIntervals", toPrice);
+    grid.intervalProfit = GetJsArray<FixedPrice>(js_grid, "intervalProfit", toPrice);
+    grid.sharesPerInterval = GetJsArray<int>(js_grid, "sharesPerInterval", toInt);
+    grid.targetPosition = GetJsArray<int>(js_grid, "targetPosition", toInt);
+
+    return grid;
+}
+
+// Sweeps the states list (as for JsStartStopLossArbCpp) over a grid of
+// {spaceBetweenIntervals, intervalProfit, sharesPerInterval, targetPosition} value
+// arrays. Returns one row per config with its totals over the stock-days.
+JS::Value JsRunParameterSweep(const JS::CallbackInfo& info)
+{
+    JS::Env env = info.Env();
+
+    const auto cpp_states_list =
+        BindJsStatesListToCppStatesList(info[0].As<JS::Array>());
+    const auto configs =
+        GetLadderConfigs(BindJsParameterGrid(info[1].As<JS::Object>()));
+
+    const auto results = RunParameterSweep(cpp_states_list, configs);
+
+    JS::Array rows = JS::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const SweepResult& result = results[i];
+
+        // Null for a config none of whose days could be simulated.
+        const auto getMeanPerDay = [&](double total) -> JS::Value
+        {
+            if (result.numDays == 0)
+            {
+                return env.Null();
+            }
+
+            return JS::Number::New(env, total / result.numDays);
+        };
+
+        JS::Object row = JS::Object::New(env);
+        row.Set(
+            "spaceBetweenIntervals",
+            JS::Number::New(env, result.config.spaceBetweenIntervals.ToDouble())
+        );
+        row.Set(
+            "intervalProfit",
+            JS::Number::New(env, result.config.intervalProfit.ToDouble())
+        );
+        row.Set(
+            "sharesPerInterval", JS::Number::New(env, result.config.sharesPerInterval)
+        );
+        row.Set("targetPosition", JS::Number::New(env, result.config.targetPosition));
+        row.Set(
+            "configHash", JS::String::New(env, format("{:016x}", result.configHash))
+        );
+        row.Set("numDays", JS::Number::New(env, result.numDays));
+        row.Set(
+            "numTrades", JS::Number::New(env, static_cast<double>(result.numTrades))
+        );
+        row.Set("realizedPnL", JS::Number::New(env, result.realizedPnL.ToDouble()));
+        row.Set("exitPnL", JS::Number::New(env, result.exitPnL.ToDouble()));
+        row.Set(
+            "meanExitPnLAsPercentage",
+            getMeanPerDay(result.exitPnLAsPercentageSum.ToDouble())
+        );
+        row.Set(
+            "worstMaxMovingLossAsPercentage",
+            result.numDays == 0
+                ? env.Null()
+                : JS::Number::New(env, result.worstMaxMovingLossAsPercentage.ToDouble())
+        );
+        row.Set("reached1PercentageProfit", getMeanPerDay(result.numReachedProfit[0]));
+        row.Set(
+            "reached075PercentageProfit",
+            getMeanPerDay(result.numReachedProfit[1])
+        );
+        row.Set("reached05PercentageProfit", getMeanPerDay(result.numReachedProfit[2]));
+        row.Set(
+            "reached025PercentageProfit",
+            getMeanPerDay(result.numReachedProfit[3])
+        );
+
+        rows.Set(static_cast<uint32_t>(i), row);
+    }
+
+    return rows;
+}
+
+// Hooks for test_node_addon_conversions.js. Prices cross as decimal text so that no
+// double rounding gets between the test and the tick values.
+
+JS::Value JsTestParseFixedPrice(const JS::CallbackInfo& info)
+{
+    JS::Env env = info.Env();
+
+    FixedPrice price{};
+    if (!TryParseFixedPrice(info[0].As<JS::String>().Utf8Value(), price))
+    {
+        return env.Null();
+    }
+
+    return JS::String::New(env, price.str());
+}
+
+JS::Value JsTestParseEasternTimestamp(const JS::CallbackInfo& info)
+{
+    JS::Env env = info.Env();
+
+    int64_t epochSeconds = 0;
+    if (!TryParseEasternTimestamp(info[0].As<JS::String>().Utf8Value(), epochSeconds))
+    {
+        return env.Null();
+    }
+
+    return JS::Number::New(env, static_cast<double>(epochSeconds));
+}
+
+JS::Value JsTestFormatEasternTimestamp(const JS::CallbackInfo& info)
+{
+    return JS::String::New(
+        info.Env(), FormatEasternTimestamp(info[0].As<JS::Number>().Int64Value())
+    );
+}
+
+// [{ask, bid, timestamp}] with ask and bid as decimal text.
+vector<Snapshot> BindJsSnapshots(const JS::Array& js_snapshots)
+{
+    vector<Snapshot> snapshots;
+    for (uint32_t i = 0; i < js_snapshots.Length(); ++i)
+    {
+        const JS::Object js_snapshot = js_snapshots.Get(i).As<JS::Object>();
+
+        Snapshot snapshot{};
+        snapshot.ask =
+            ParseFixedPrice(js_snapshot.Get("ask").As<JS::String>().Utf8Value());
+        snapshot.bid =
+            ParseFixedPrice(js_snapshot.Get("bid").As<JS::String>().Utf8Value());
+        snapshot.timestamp = js_snapshot.Get("timestamp").As<JS::Number>().Int64Value();
+
+        snapshots.push_back(snapshot);
+    }
+
+    return snapshots;
+}
+
+JS::Value JsTestGetPriceQuantum(const JS::CallbackInfo& info)
+{
+    const vector<Snapshot> snapshots = BindJsSnapshots(info[0].As<JS::Array>());
+
+    return JS::String::New(
+        info.Env(), FixedPrice::FromTicks(GetPriceQuantum(snapshots)).str()
+    );
+}
+
+// Codes the snapshots as one block, in units of their price quantum.
+JS::Value JsTestEncodeSnapshotBlock(const JS::CallbackInfo& info)
+{
+    const vector<Snapshot> snapshots = BindJsSnapshots(info[0].As<JS::Array>());
+
+    vector<uint8_t> block;
+    EncodeSnapshotBlock(snapshots, GetPriceQuantum(snapshots), block);
+
+    return JS::Buffer<uint8_t>::Copy(info.Env(), block.data(), block.size());
+}
+
+// (block, priceQuantum, numSnapshots); throws like DecodeSnapshotBlock.
+JS::Value JsTestDecodeSnapshotBlock(const JS::CallbackInfo& info)
+{
+    JS::Env env = info.Env();
+
+    const auto block = info[0].As<JS::Buffer<uint8_t>>();
+    const FixedPrice priceQuantum =
+        ParseFixedPrice(info[1].As<JS::String>().Utf8Value());
+
+    vector<Snapshot> snapshots(info[2].As<JS::Number>().Uint32Value());
+    DecodeSnapshotBlock(
+        span<const uint8_t>(block.Data(), block.Length()), priceQuantum.ticks, snapshots
+    );
+
+    JS::Array result = JS::Array::New(env, snapshots.size());
+    for (size_t i = 0; i < snapshots.size(); ++i)
+    {
+        JS::Object snapshot = JS::Object::New(env);
+        snapshot.Set("ask", JS::String::New(env, snapshots[i].ask.str()));
+        snapshot.Set("bid", JS::String::New(env, snapshots[i].bid.str()));
+        snapshot.Set(
+            "timestamp",
+            JS::Number::New(env, static_cast<double>(snapshots[i].timestamp))
+        );
+
+        result.Set(static_cast<uint32_t>(i), snapshot);
+    }
+
+    return result;
+}
+
 JS::Object Init(JS::Env env, JS::Object exports)
 {
     exports.Set(
@@ -37,6 +355,66 @@ JS::Object Init(JS::Env env, JS::Object exports)
         JS::Function::New(env, JsStartStopLossArbCpp)
     );
 
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsRunNumericConversionsBenchmark)),
+        JS::Function::New(env, JsRunNumericConversionsBenchmark)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsConvertSnapshotJsonFilesToBinary)),
+        JS::Function::New(env, JsConvertSnapshotJsonFilesToBinary)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsConvertRawQuoteFilesToSnapshots)),
+        JS::Function::New(env, JsConvertRawQuoteFilesToSnapshots)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsUpdateDatasetManifest)),
+        JS::Function::New(env, JsUpdateDatasetManifest)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsGetDatasetManifestEntriesOnDate)),
+        JS::Function::New(env, JsGetDatasetManifestEntriesOnDate)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsRunParameterSweep)),
+        JS::Function::New(env, JsRunParameterSweep)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsTestParseFixedPrice)),
+        JS::Function::New(env, JsTestParseFixedPrice)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsTestParseEasternTimestamp)),
+        JS::Function::New(env, JsTestParseEasternTimestamp)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsTestFormatEasternTimestamp)),
+        JS::Function::New(env, JsTestFormatEasternTimestamp)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsTestGetPriceQuantum)),
+        JS::Function::New(env, JsTestGetPriceQuantum)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsTestEncodeSnapshotBlock)),
+        JS::Function::New(env, JsTestEncodeSnapshotBlock)
+    );
+
+    exports.Set(
+        JS::String::New(env, GET_SYMBOL_NAME(JsTestDecodeSnapshotBlock)),
+        JS::Function::New(env, JsTestDecodeSnapshotBlock)
+    );
+
     return exports;
 }
 
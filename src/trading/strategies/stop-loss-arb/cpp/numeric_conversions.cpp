@@ -0,0 +1,318 @@
+#include "numeric_conversions.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <string>
+
+using namespace std;
+
+const int kMaxDecimalPowerOfTen = 40;
+
+struct DecimalPowersOfTen
+{
+    // positive[i] = 10^i and negative[i] = 10^-i, both exact in cpp_dec_float.
+    array<Decimal, kMaxDecimalPowerOfTen + 1> positive;
+    array<Decimal, kMaxDecimalPowerOfTen + 1> negative;
+};
+
+const DecimalPowersOfTen& GetDecimalPowersOfTen()
+{
+    static const DecimalPowersOfTen powers = []()
+    {
+        DecimalPowersOfTen result{};
+        for (int i = 0; i <= kMaxDecimalPowerOfTen; ++i)
+        {
+            result.positive[i] = Decimal{format("1e{}", i)};
+            result.negative[i] = Decimal{format("1e-{}", i)};
+        }
+
+        return result;
+    }();
+
+    return powers;
+}
+
+const array<double, 23> kDoublePowersOfTen = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+const array<uint64_t, 20> kIntegerPowersOfTen = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+bool IsDigit(char character) { return character >= '0' && character <= '9'; }
+
+bool TryParseDecimalText(std::string_view text, DecimalText& result)
+{
+    result = DecimalText{};
+
+    const char* it = text.data();
+    const char* const end = text.data() + text.size();
+
+    if (it != end && *it == '-')
+    {
+        result.negative = true;
+        ++it;
+    }
+
+    const char* const integer_begin = it;
+    while (it != end && IsDigit(*it))
+    {
+        ++it;
+    }
+    const char* const integer_end = it;
+
+    const char* fraction_begin = it;
+    const char* fraction_end = it;
+    if (it != end && *it == '.')
+    {
+        fraction_begin = ++it;
+        while (it != end && IsDigit(*it))
+        {
+            ++it;
+        }
+        fraction_end = it;
+    }
+
+    if (integer_begin == integer_end && fraction_begin == fraction_end)
+    {
+        return false;
+    }
+
+    int exponent = 0;
+    if (it != end && (*it == 'e' || *it == 'E'))
+    {
+        ++it;
+        if (it != end && *it == '+')
+        {
+            ++it;
+        }
+
+        const auto [exponent_end, error] = from_chars(it, end, exponent);
+        if (error != errc{})
+        {
+            return false;
+        }
+        it = exponent_end;
+    }
+
+    if (it != end)
+    {
+        return false;
+    }
+
+    // Trailing fraction zeros do not change the value and leading integer zeros do not
+    // count towards the digits a uint64_t can hold.
+    while (fraction_end != fraction_begin && *(fraction_end - 1) == '0')
+    {
+        --fraction_end;
+    }
+
+    const char* significant_begin = integer_begin;
+    while (significant_begin != integer_end && *significant_begin == '0')
+    {
+        ++significant_begin;
+    }
+
+    const auto num_integer_digits = integer_end - significant_begin;
+    const auto num_fraction_digits = fraction_end - fraction_begin;
+    if (num_integer_digits + num_fraction_digits > 19)
+    {
+        return false;
+    }
+
+    uint64_t integer_part = 0;
+    if (significant_begin != integer_end)
+    {
+        from_chars(significant_begin, integer_end, integer_part);
+    }
+
+    uint64_t fraction_part = 0;
+    if (fraction_begin != fraction_end)
+    {
+        from_chars(fraction_begin, fraction_end, fraction_part);
+    }
+
+    const uint64_t fraction_scale = kIntegerPowersOfTen[num_fraction_digits];
+    if (integer_part > (UINT64_MAX - fraction_part) / fraction_scale)
+    {
+        return false;
+    }
+
+    result.mantissa = integer_part * fraction_scale + fraction_part;
+    result.exponent = exponent - static_cast<int>(num_fraction_digits);
+
+    return true;
+}
+
+bool TryParseFixedPrice(std::string_view text, FixedPrice& result)
+{
+    DecimalText decimal_text{};
+    if (!TryParseDecimalText(text, decimal_text))
+    {
+        return false;
+    }
+
+    const int tick_exponent = decimal_text.exponent + kFixedPriceDecimals;
+
+    uint64_t magnitude = 0;
+    if (tick_exponent >= 0)
+    {
+        if (tick_exponent > 18 ||
+            decimal_text.mantissa > INT64_MAX / kIntegerPowersOfTen[tick_exponent])
+        {
+            return false;
+        }
+
+        magnitude = decimal_text.mantissa * kIntegerPowersOfTen[tick_exponent];
+    }
+    else if (-tick_exponent <= 19)
+    {
+        // More decimals than a tick holds: round half away from zero.
+        const uint64_t divisor = kIntegerPowersOfTen[-tick_exponent];
+        magnitude = decimal_text.mantissa / divisor;
+        if (decimal_text.mantissa % divisor >= divisor - divisor / 2)
+        {
+            magnitude++;
+        }
+    }
+
+    if (magnitude > INT64_MAX)
+    {
+        return false;
+    }
+
+    const int64_t ticks = static_cast<int64_t>(magnitude);
+    result = FixedPrice::FromTicks(decimal_text.negative ? -ticks : ticks);
+
+    return true;
+}
+
+FixedPrice ParseFixedPrice(std::string_view text)
+{
+    FixedPrice result{};
+    if (!TryParseFixedPrice(text, result))
+    {
+        throw exception(format("Invalid price: \"{}\"", text).c_str());
+    }
+
+    return result;
+}
+
+Decimal GetDecimal(const DecimalText& decimal_text)
+{
+    const auto& powers = GetDecimalPowersOfTen();
+
+    Decimal result{static_cast<unsigned long long>(decimal_text.mantissa)};
+
+    if (decimal_text.exponent > 0)
+    {
+        result *= powers.positive[decimal_text.exponent];
+    }
+    else if (decimal_text.exponent < 0)
+    {
+        result *= powers.negative[-decimal_text.exponent];
+    }
+
+    return decimal_text.negative ? -result : result;
+}
+
+bool IsInDecimalPowersRange(const DecimalText& decimal_text)
+{
+    return decimal_text.exponent >= -kMaxDecimalPowerOfTen &&
+           decimal_text.exponent <= kMaxDecimalPowerOfTen;
+}
+
+Decimal GetDecimal(const double& value)
+{
+    array<char, 64> buffer{};
+    const auto [end, error] = to_chars(
+        buffer.data(),
+        buffer.data() + buffer.size() - 1,
+        value,
+        chars_format::general,
+        kDecimalPrecision
+    );
+
+    DecimalText decimal_text{};
+    if (error == errc{} &&
+        TryParseDecimalText(string_view(buffer.data(), end), decimal_text) &&
+        IsInDecimalPowersRange(decimal_text))
+    {
+        return GetDecimal(decimal_text);
+    }
+
+    // nan, inf and extreme exponents
+    return Decimal{buffer.data()};
+}
+
+Decimal GetDecimal(const FixedPrice& value)
+{
+    const uint64_t magnitude =
+        value.ticks < 0 ? 0 - uint64_t(value.ticks) : uint64_t(value.ticks);
+
+    return GetDecimal(DecimalText{value.ticks < 0, magnitude, -kFixedPriceDecimals});
+}
+
+Decimal ParseDecimal(std::string_view text)
+{
+    DecimalText decimal_text{};
+    if (TryParseDecimalText(text, decimal_text) && IsInDecimalPowersRange(decimal_text))
+    {
+        return GetDecimal(decimal_text);
+    }
+
+    return Decimal{string(text)};
+}
+
+double ToDouble(const Decimal& value)
+{
+    if (value.is_zero() || !boost::multiprecision::isfinite(value))
+    {
+        return value.convert_to<double>();
+    }
+
+    // Scale so the value becomes an integer of at most 15 digits, round it to the
+    // nearest one, then divide once by an exact power of ten.
+    const int scale = 14 - static_cast<int>(value.backend().order());
+    if (scale < -22 || scale > 22)
+    {
+        return value.convert_to<double>();
+    }
+
+    const auto& powers = GetDecimalPowersOfTen();
+    if (scale >= 0)
+    {
+        const Decimal scaled =
+            boost::multiprecision::round(value * powers.positive[scale]);
+        return static_cast<double>(scaled.convert_to<long long>()) /
+               kDoublePowersOfTen[scale];
+    }
+
+    const Decimal scaled =
+        boost::multiprecision::round(value * powers.negative[-scale]);
+    return static_cast<double>(scaled.convert_to<long long>()) *
+           kDoublePowersOfTen[-scale];
+}
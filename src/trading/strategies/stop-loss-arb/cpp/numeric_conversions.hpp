@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "fixed_price.hpp"
+#include "utils.hpp"
+
+// Conversions between text, double, Decimal and FixedPrice. None of them allocate:
+// text is produced and consumed with std::to_chars/std::from_chars on stack buffers,
+// and Decimals are built from an integer mantissa and a power-of-ten table instead of
+// being round-tripped through a string.
+
+// Decimal text as sign * mantissa * 10^exponent, e.g. "-9.37" -> {true, 937, -2}.
+struct DecimalText
+{
+    bool negative = false;
+    uint64_t mantissa = 0;
+    int exponent = 0;
+};
+
+// Parses JSON-style number text ("9.37", "-0.5", "1e-05"). Returns false if the text
+// is not a number or has more significant digits than fit in a uint64_t.
+bool TryParseDecimalText(std::string_view text, DecimalText& result);
+
+bool TryParseFixedPrice(std::string_view text, FixedPrice& result);
+
+// Throws if `text` is not a number.
+FixedPrice ParseFixedPrice(std::string_view text);
+
+// Same rounding as the former ostringstream conversion: the double is first
+// formatted with kDecimalPrecision significant digits.
+Decimal GetDecimal(const double& value);
+
+template <typename Integer>
+    requires std::is_integral_v<Integer>
+Decimal GetDecimal(const Integer& value)
+{
+    return Decimal{static_cast<long long>(value)};
+}
+
+Decimal GetDecimal(const FixedPrice& value);
+
+// Throws if `text` is not a number.
+Decimal ParseDecimal(std::string_view text);
+
+// Rounds to 15 significant digits, so exact for Decimals that have no more; replaces
+// convert_to<double>, which formats and re-parses through a stringstream.
+double ToDouble(const Decimal& value);
@@ -0,0 +1,168 @@
+#include "numeric_conversions_benchmark.hpp"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "numeric_conversions.hpp"
+
+using namespace std;
+
+// Baselines: the conversions as they were before numeric_conversions.
+Decimal LegacyGetDecimal(const double& value)
+{
+    std::ostringstream oss{};
+    oss.precision(kDecimalPrecision);
+    oss << value;
+    return Decimal{oss.str()};
+}
+
+// Folds a Decimal into the benchmark checksum without converting it.
+double GetChecksum(const Decimal& value) { return value.is_zero() ? 0.0 : 1.0; }
+
+double LegacyToDouble(const Decimal& value) { return value.convert_to<double>(); }
+
+// What parsing a JSON price amounted to: nlohmann's double, then GetDecimal.
+Decimal LegacyParseJsonPrice(const string& text)
+{
+    return LegacyGetDecimal(strtod(text.c_str(), nullptr));
+}
+
+template <typename Convert>
+double GetConversionsPerSecond(int num_conversions, Convert&& convert)
+{
+    const auto start_time = chrono::steady_clock::now();
+
+    double checksum = 0;
+    for (int i = 0; i < num_conversions; ++i)
+    {
+        checksum += convert(i);
+    }
+
+    const auto end_time = chrono::steady_clock::now();
+    const double elapsed_seconds =
+        chrono::duration<double>(end_time - start_time).count();
+
+    // Keeps the conversions from being optimized away.
+    volatile double sink = checksum;
+    (void)sink;
+
+    return num_conversions / elapsed_seconds;
+}
+
+void PrintBenchmarkRow(const string& name, double before, double after)
+{
+    Print(format(
+        "{:<26} {:>14.0f} {:>14.0f} {:>8.1f}x", name, before, after, after / before
+    ));
+}
+
+void RunNumericConversionsBenchmark(int num_conversions)
+{
+    const int num_samples = 4096;
+
+    mt19937 random_engine{42};
+    uniform_int_distribution<int> cents_distribution{1, 50'000};
+
+    vector<double> doubles;
+    vector<string> texts;
+    vector<Decimal> decimals;
+    vector<FixedPrice> fixed_prices;
+    for (int i = 0; i < num_samples; ++i)
+    {
+        const double value = cents_distribution(random_engine) / 100.0;
+
+        array<char, 32> buffer{};
+        const auto end =
+            to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr;
+
+        doubles.push_back(value);
+        texts.emplace_back(buffer.data(), end);
+        decimals.push_back(LegacyGetDecimal(value));
+        fixed_prices.push_back(FixedPrice::FromDouble(value));
+    }
+
+    const auto sample = [num_samples](int i) { return i & (num_samples - 1); };
+
+    Print(format(
+        "Numeric conversions benchmark ({} conversions, conversions per second)",
+        num_conversions
+    ));
+    Print(format(
+        "{:<26} {:>14} {:>14} {:>9}", "conversion", "before", "after", "speedup"
+    ));
+
+    PrintBenchmarkRow(
+        "double -> Decimal",
+        GetConversionsPerSecond(
+            num_conversions,
+            [&](int i) { return GetChecksum(LegacyGetDecimal(doubles[sample(i)])); }
+        ),
+        GetConversionsPerSecond(
+            num_conversions,
+            [&](int i) { return GetChecksum(GetDecimal(doubles[sample(i)])); }
+        )
+    );
+
+    PrintBenchmarkRow(
+        "Decimal -> double",
+        GetConversionsPerSecond(
+            num_conversions, [&](int i) { return LegacyToDouble(decimals[sample(i)]); }
+        ),
+        GetConversionsPerSecond(
+            num_conversions, [&](int i) { return ToDouble(decimals[sample(i)]); }
+        )
+    );
+
+    PrintBenchmarkRow(
+        "JSON text -> Decimal",
+        GetConversionsPerSecond(
+            num_conversions,
+            [&](int i) { return GetChecksum(LegacyParseJsonPrice(texts[sample(i)])); }
+        ),
+        GetConversionsPerSecond(
+            num_conversions,
+            [&](int i) { return GetChecksum(ParseDecimal(texts[sample(i)])); }
+        )
+    );
+
+    PrintBenchmarkRow(
+        "JSON text -> price",
+        GetConversionsPerSecond(
+            num_conversions,
+            [&](int i) { return GetChecksum(LegacyParseJsonPrice(texts[sample(i)])); }
+        ),
+        GetConversionsPerSecond(
+            num_conversions,
+            [&](int i) { return double(ParseFixedPrice(texts[sample(i)]).ticks); }
+        )
+    );
+
+    PrintBenchmarkRow(
+        "double -> price",
+        GetConversionsPerSecond(
+            num_conversions,
+            [&](int i) { return GetChecksum(LegacyGetDecimal(doubles[sample(i)])); }
+        ),
+        GetConversionsPerSecond(
+            num_conversions,
+            [&](int i) { return FixedPrice::FromDouble(doubles[sample(i)]).ToDouble(); }
+        )
+    );
+
+    PrintBenchmarkRow(
+        "price -> double",
+        GetConversionsPerSecond(
+            num_conversions, [&](int i) { return LegacyToDouble(decimals[sample(i)]); }
+        ),
+        GetConversionsPerSecond(
+            num_conversions, [&](int i) { return fixed_prices[sample(i)].ToDouble(); }
+        )
+    );
+}
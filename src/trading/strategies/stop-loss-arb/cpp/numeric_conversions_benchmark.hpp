@@ -0,0 +1,5 @@
+#pragma once
+
+// Prints conversions per second of the ostringstream/convert_to<double> conversions
+// the engine used to do next to their numeric_conversions replacements.
+void RunNumericConversionsBenchmark(int num_conversions);
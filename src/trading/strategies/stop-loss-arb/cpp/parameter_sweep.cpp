@@ -0,0 +1,205 @@
+#include "parameter_sweep.hpp"
+
+#include <algorithm>
+#include <format>
+
+#include "config_lanes.hpp"
+#include "new_state.hpp"
+#include "results_sink.hpp"
+#include "simulate_day.hpp"
+#include "snapshot_cache.hpp"
+#include "utils.hpp"
+#include "work_stealing_pool.hpp"
+
+using namespace std;
+
+std::vector<LadderConfig> GetLadderConfigs(const ParameterGrid& grid)
+{
+    if (grid.spaceBetweenIntervals.empty() || grid.intervalProfit.empty() ||
+        grid.sharesPerInterval.empty() || grid.targetPosition.empty())
+    {
+        throw exception("Every parameter of the sweep grid needs at least one value");
+    }
+
+    const auto isPositive = [](int value) { return value > 0; };
+    if (!ranges::all_of(grid.sharesPerInterval, isPositive) ||
+        !ranges::all_of(grid.targetPosition, isPositive))
+    {
+        throw exception("Sweep sharesPerInterval and targetPosition must be positive");
+    }
+
+    vector<LadderConfig> configs;
+    for (const FixedPrice space : grid.spaceBetweenIntervals)
+    {
+        for (const FixedPrice profit : grid.intervalProfit)
+        {
+            for (const int shares : grid.sharesPerInterval)
+            {
+                for (const int target : grid.targetPosition)
+                {
+                    configs.push_back(LadderConfig{space, profit, shares, target});
+                }
+            }
+        }
+    }
+
+    return configs;
+}
+
+StockState GetConfiguredStockState(
+    const StockState& stockState, const LadderConfig& config
+)
+{
+    StockState partial = stockState;
+    partial.spaceBetweenIntervals = config.spaceBetweenIntervals;
+    partial.intervalProfit = config.intervalProfit;
+    partial.sharesPerInterval = config.sharesPerInterval;
+    partial.targetPosition = config.targetPosition;
+
+    return GetFullStockState(partial);
+}
+
+// The config hash hashes these too, so a sweep row's hash only matches its days'
+// records in the results sink if every day has the same values.
+bool HasSameUnsweptSettings(const StockState& lhs, const StockState& rhs)
+{
+    return lhs.isStaticIntervals == rhs.isStaticIntervals &&
+           lhs.brokerageTradingCostPerShare == rhs.brokerageTradingCostPerShare &&
+           lhs.shiftIntervalsFromInitialPrice == rhs.shiftIntervalsFromInitialPrice &&
+           lhs.numContracts == rhs.numContracts;
+}
+
+std::vector<SweepResult> RunParameterSweep(
+    const std::vector<std::unordered_map<std::string, StockState>>& states_list,
+    const std::vector<LadderConfig>& configs
+)
+{
+    vector<pair<const string*, const StockState*>> stockDays;
+    for (const auto& states : states_list)
+    {
+        for (const auto& [stock, state] : states)
+        {
+            stockDays.emplace_back(&stock, &state);
+        }
+    }
+
+    for (const auto& [stock, state] : stockDays)
+    {
+        const auto& [firstStock, firstState] = stockDays.front();
+        if (!HasSameUnsweptSettings(*state, *firstState))
+        {
+            throw exception(
+                format(
+                    "{} on {} differs from {} on {} in a setting the sweep keeps",
+                    *stock,
+                    state->date,
+                    *firstStock,
+                    firstState->date
+                )
+                    .c_str()
+            );
+        }
+    }
+
+    const size_t numConfigs = configs.size();
+
+    // Indexed [stock-day * numConfigs + config], so the totals below add up in the
+    // same order however the days were scheduled.
+    vector<DayResult> dayResults(stockDays.size() * numConfigs);
+    vector<char> isDaySimulated(stockDays.size(), false);
+
+    RunOnWorkerPool(
+        stockDays.size(),
+        [&](size_t day)
+        {
+            const string& stock = *stockDays[day].first;
+            const StockState& stockState = *stockDays[day].second;
+
+            shared_ptr<const SnapshotDataset> dataset;
+            try
+            {
+                dataset = GetSnapshotDataset(stockState);
+            }
+            catch (const std::exception& e)
+            {
+                Print(format("Skipped {} on {}: {}", stock, stockState.date, e.what()));
+                return;
+            }
+
+            vector<StockState> configuredStates;
+            configuredStates.reserve(numConfigs);
+            for (const LadderConfig& config : configs)
+            {
+                configuredStates.push_back(GetConfiguredStockState(stockState, config));
+            }
+
+            vector<DayResult> results;
+            if (IsLaneKernelDisabled())
+            {
+                for (StockState& configuredState : configuredStates)
+                {
+                    results.push_back(SimulateDay(
+                        stock, configuredState, dataset->snapshots, &dataset->blocks
+                    ));
+                }
+            }
+            else
+            {
+                results =
+                    SimulateDayForConfigs(stock, configuredStates, dataset->snapshots);
+            }
+
+            for (size_t i = 0; i < numConfigs; ++i)
+            {
+                AppendDayResult(stock, configuredStates[i], results[i]);
+                dayResults[day * numConfigs + i] = results[i];
+            }
+
+            isDaySimulated[day] = true;
+        }
+    );
+
+    FlushResults();
+
+    vector<SweepResult> results;
+    for (size_t i = 0; i < numConfigs; ++i)
+    {
+        SweepResult result{};
+        result.config = configs[i];
+        if (!stockDays.empty())
+        {
+            result.configHash = GetConfigHash(
+                GetConfiguredStockState(*stockDays.front().second, configs[i])
+            );
+        }
+        result.worstMaxMovingLossAsPercentage = FixedPrice::Max();
+
+        for (size_t day = 0; day < stockDays.size(); ++day)
+        {
+            if (!isDaySimulated[day])
+            {
+                continue;
+            }
+
+            const DayResult& dayResult = dayResults[day * numConfigs + i];
+
+            result.numDays++;
+            result.numTrades += dayResult.numTrades;
+            result.realizedPnL += dayResult.realizedPnL;
+            result.exitPnL += dayResult.exitPnL;
+            result.exitPnLAsPercentageSum += dayResult.exitPnLAsPercentage;
+            result.worstMaxMovingLossAsPercentage = min(
+                result.worstMaxMovingLossAsPercentage,
+                dayResult.maxMovingLossAsPercentage
+            );
+            result.numReachedProfit[0] += dayResult.reached_1_percentage_profit;
+            result.numReachedProfit[1] += dayResult.reached_0_75_percentage_profit;
+            result.numReachedProfit[2] += dayResult.reached_0_5_percentage_profit;
+            result.numReachedProfit[3] += dayResult.reached_0_25_percentage_profit;
+        }
+
+        results.push_back(result);
+    }
+
+    return results;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+// The settings a sweep varies; everything else comes from the stock-day's state.
+struct LadderConfig
+{
+    FixedPrice spaceBetweenIntervals;
+    FixedPrice intervalProfit;
+    int sharesPerInterval;
+    int targetPosition;
+};
+
+struct ParameterGrid
+{
+    std::vector<FixedPrice> spaceBetweenIntervals;
+    std::vector<FixedPrice> intervalProfit;
+    std::vector<int> sharesPerInterval;
+    std::vector<int> targetPosition;
+};
+
+// Every combination of the grid's values, the last field varying fastest. Throws on
+// an empty axis or a non-positive size.
+std::vector<LadderConfig> GetLadderConfigs(const ParameterGrid& grid);
+
+// One config's totals over the stock-days it ran on.
+struct SweepResult
+{
+    LadderConfig config;
+    uint64_t configHash;  // GetConfigHash, as in the results sink
+    int numDays;
+    int64_t numTrades;
+    FixedPrice realizedPnL;
+    FixedPrice exitPnL;
+    FixedPrice exitPnLAsPercentageSum;
+    FixedPrice worstMaxMovingLossAsPercentage;
+    int numReachedProfit[4];  // days that reached 1%, 0.75%, 0.5% and 0.25% profit
+};
+
+// Runs every historical stock-day under every config. Each (date, ticker) is one task
+// on the worker pool: its snapshots are loaded once and all the configs' ladders, built
+// natively (GetFullStockState), run over them back to back while they are still in
+// that core's cache. Every day's result is also appended to the results sink under
+// its config's hash. Days that fail to load are reported and left out. Throws if the
+// stock-days differ in a setting the sweep does not vary (costs, contracts, ...).
+std::vector<SweepResult> RunParameterSweep(
+    const std::vector<std::unordered_map<std::string, StockState>>& states_list,
+    const std::vector<LadderConfig>& configs
+);
@@ -0,0 +1,876 @@
+#include "parity.hpp"
+
+#include <atomic>
+#include <format>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "algo.hpp"
+#include "interval_ladder.hpp"
+#include "numeric_conversions.hpp"
+#include "price_simulator.hpp"
+#include "repeated_quotes.hpp"
+#include "simulate_day.hpp"
+#include "snapshot_cache.hpp"
+#include "timestamp.hpp"
+#include "work_stealing_pool.hpp"
+
+using namespace std;
+
+bool IsDecimalParity() { return IsTruthyEnv("DECIMAL_PARITY"); }
+
+// Reference engine: the cpp_dec_float<12> algorithm as it was before the engine moved
+// to FixedPrice. It is only used to diff the FixedPrice engine against, so it is kept
+// as close to the original code as possible and must not pick up optimizations.
+namespace
+{
+struct DecimalSnapshot
+{
+    Decimal ask;
+    Decimal bid;
+    int64_t timestamp;
+};
+
+struct DecimalInterval
+{
+    struct OrderActionDetails
+    {
+        bool active;
+        bool crossed;
+        Decimal price;
+        std::optional<Decimal> boughtAtPrice;
+        std::optional<Decimal> soldAtPrice;
+    };
+
+    IntervalType type;
+    int positionLimit;
+    OrderActionDetails SELL;
+    OrderActionDetails BUY;
+};
+
+struct DecimalTradingLog
+{
+    int64_t timeStamp;
+    std::string action;
+    Decimal price;
+    int previousPosition;
+    int newPosition;
+};
+
+struct DecimalStockState
+{
+    bool isStaticIntervals;
+    Decimal brokerageTradingCostPerShare;
+    int sharesPerInterval;
+    Decimal initialPrice;
+    Decimal spaceBetweenIntervals;
+    int position;
+    int targetPosition;
+    Decimal realizedPnL;
+    Decimal exitPnL;
+    Decimal exitPnLAsPercentage;
+    Decimal maxMovingProfitAsPercentage;
+    Decimal maxMovingLossAsPercentage;
+    bool reached_1_percentage_profit;
+    Decimal max_loss_when_reached_1_percentage_profit;
+    bool reached_0_75_percentage_profit;
+    Decimal max_loss_when_reached_0_75_percentage_profit;
+    bool reached_0_5_percentage_profit;
+    Decimal max_loss_when_reached_0_5_percentage_profit;
+    bool reached_0_25_percentage_profit;
+    Decimal max_loss_when_reached_0_25_percentage_profit;
+    Decimal lastAsk;
+    Decimal lastBid;
+    std::vector<DecimalInterval> intervals;
+    std::vector<DecimalTradingLog> tradingLogs;
+};
+
+Decimal ToDecimal(const FixedPrice& price) { return GetDecimal(price); }
+
+std::optional<Decimal> ToDecimal(const std::optional<FixedPrice>& price)
+{
+    if (!price.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return GetDecimal(price.value());
+}
+
+int64_t ToTicks(const Decimal& value)
+{
+    return boost::multiprecision::round(value * kFixedPriceScale).convert_to<int64_t>();
+}
+
+DecimalStockState ToDecimalStockState(const StockState& state)
+{
+    DecimalStockState result{};
+
+    result.isStaticIntervals = state.isStaticIntervals;
+    result.brokerageTradingCostPerShare = ToDecimal(state.brokerageTradingCostPerShare);
+    result.sharesPerInterval = state.sharesPerInterval;
+    result.initialPrice = ToDecimal(state.initialPrice);
+    result.spaceBetweenIntervals = ToDecimal(state.spaceBetweenIntervals);
+    result.position = state.position;
+    result.targetPosition = state.targetPosition;
+    result.realizedPnL = ToDecimal(state.realizedPnL);
+    result.exitPnL = ToDecimal(state.exitPnL);
+    result.exitPnLAsPercentage = ToDecimal(state.exitPnLAsPercentage);
+    result.maxMovingProfitAsPercentage = ToDecimal(state.maxMovingProfitAsPercentage);
+    result.maxMovingLossAsPercentage = ToDecimal(state.maxMovingLossAsPercentage);
+    result.lastAsk = ToDecimal(state.lastAsk);
+    result.lastBid = ToDecimal(state.lastBid);
+
+    for (const auto& interval : GetSmoothingIntervals(state.intervals))
+    {
+        DecimalInterval decimal_interval{};
+        decimal_interval.type = interval.type;
+        decimal_interval.positionLimit = interval.positionLimit;
+
+        decimal_interval.SELL.active = interval.SELL.active;
+        decimal_interval.SELL.crossed = interval.SELL.crossed;
+        decimal_interval.SELL.price = ToDecimal(interval.SELL.price);
+        decimal_interval.SELL.boughtAtPrice = ToDecimal(interval.SELL.boughtAtPrice);
+
+        decimal_interval.BUY.active = interval.BUY.active;
+        decimal_interval.BUY.crossed = interval.BUY.crossed;
+        decimal_interval.BUY.price = ToDecimal(interval.BUY.price);
+        decimal_interval.BUY.soldAtPrice = ToDecimal(interval.BUY.soldAtPrice);
+
+        result.intervals.push_back(decimal_interval);
+    }
+
+    return result;
+}
+
+bool CheckCrossings(DecimalStockState& stockState, const DecimalSnapshot& snapshot)
+{
+    bool crossingHappened = false;
+    for (auto& interval : stockState.intervals)
+    {
+        if (interval.BUY.active && !interval.BUY.crossed &&
+            snapshot.ask < interval.BUY.price)
+        {
+            interval.BUY.crossed = true;
+            crossingHappened = true;
+        }
+
+        if (interval.SELL.active && !interval.SELL.crossed &&
+            snapshot.bid > interval.SELL.price)
+        {
+            interval.SELL.crossed = true;
+            crossingHappened = true;
+        }
+    }
+
+    return crossingHappened;
+}
+
+void CorrectBadBuyIfRequired(DecimalStockState& stockState, vector<int>& indexes)
+{
+    auto& intervals = stockState.intervals;
+
+    int lowestIndexExecuted = indexes.back();
+    if (lowestIndexExecuted >= static_cast<int>(intervals.size()) - 1)
+    {
+        return;
+    }
+
+    auto& intervalBelow = intervals[lowestIndexExecuted + 1];
+    if (!intervalBelow.BUY.active)
+    {
+        return;
+    }
+
+    intervalBelow.BUY.active = false;
+    intervalBelow.BUY.crossed = false;
+    intervalBelow.SELL.active = true;
+    intervalBelow.SELL.crossed = false;
+
+    auto& topIntervalExecuted = intervals[indexes[0]];
+    topIntervalExecuted.BUY.active = true;
+    topIntervalExecuted.BUY.crossed = false;
+    topIntervalExecuted.SELL.active = false;
+    topIntervalExecuted.SELL.crossed = false;
+
+    for (auto& interval : intervals)
+    {
+        interval.BUY.price = interval.BUY.price + stockState.spaceBetweenIntervals;
+        interval.SELL.price = interval.SELL.price + stockState.spaceBetweenIntervals;
+    }
+}
+
+void CorrectBadSellIfRequired(DecimalStockState& stockState, vector<int>& indexes)
+{
+    auto& intervals = stockState.intervals;
+
+    int highestIndexExecuted = indexes[0];
+    if (highestIndexExecuted == 0)
+    {
+        return;
+    }
+
+    auto& intervalAbove = intervals[highestIndexExecuted - 1];
+    if (!intervalAbove.SELL.active)
+    {
+        return;
+    }
+
+    intervalAbove.SELL.active = false;
+    intervalAbove.SELL.crossed = false;
+    intervalAbove.BUY.active = true;
+    intervalAbove.BUY.crossed = false;
+
+    auto& bottomIntervalExecuted = intervals[indexes.back()];
+    bottomIntervalExecuted.SELL.active = true;
+    bottomIntervalExecuted.SELL.crossed = false;
+    bottomIntervalExecuted.BUY.active = false;
+    bottomIntervalExecuted.BUY.crossed = false;
+
+    for (auto& interval : intervals)
+    {
+        interval.BUY.price = interval.BUY.price - stockState.spaceBetweenIntervals;
+        interval.SELL.price = interval.SELL.price - stockState.spaceBetweenIntervals;
+    }
+}
+
+vector<int> GetNumToBuy(DecimalStockState& stockState, const DecimalSnapshot& snapshot)
+{
+    auto& intervals = stockState.intervals;
+
+    int newPosition = stockState.position;
+    vector<int> indicesToExecute;
+
+    for (int i = intervals.size() - 1; i >= 0; --i)
+    {
+        const auto& interval = intervals[i];
+
+        if (snapshot.ask >= interval.BUY.price && interval.BUY.active &&
+            interval.BUY.crossed && newPosition < interval.positionLimit)
+        {
+            indicesToExecute.insert(indicesToExecute.begin(), i);
+            newPosition += stockState.sharesPerInterval;
+        }
+    }
+
+    for (const int index : indicesToExecute)
+    {
+        auto& interval = intervals[index];
+
+        interval.BUY.active = false;
+        interval.BUY.crossed = false;
+
+        interval.SELL.active = true;
+        interval.SELL.crossed = false;
+    }
+
+    if (stockState.isStaticIntervals && !indicesToExecute.empty())
+    {
+        int bottomOriginalIndexToExecute = indicesToExecute.back();
+        for (int i = intervals.size() - 1; i > bottomOriginalIndexToExecute; --i)
+        {
+            if (intervals[i].BUY.active)
+            {
+                indicesToExecute.push_back(i);
+            }
+        }
+    }
+
+    if (!indicesToExecute.empty() && !stockState.isStaticIntervals)
+    {
+        CorrectBadBuyIfRequired(stockState, indicesToExecute);
+    }
+
+    return indicesToExecute;
+}
+
+vector<int> GetNumToSell(DecimalStockState& stockState, const DecimalSnapshot& snapshot)
+{
+    auto& intervals = stockState.intervals;
+
+    int newPosition = stockState.position;
+    vector<int> indicesToExecute;
+
+    for (int i = 0; i < static_cast<int>(intervals.size()); ++i)
+    {
+        const auto& interval = intervals[i];
+
+        if (snapshot.bid <= interval.SELL.price && interval.SELL.active &&
+            interval.SELL.crossed && newPosition > interval.positionLimit)
+        {
+            indicesToExecute.push_back(i);
+            newPosition -= stockState.sharesPerInterval;
+        }
+    }
+
+    if (stockState.isStaticIntervals && !indicesToExecute.empty())
+    {
+        int topOriginalIndexToExecute = indicesToExecute[0];
+        for (int i = 0; i < topOriginalIndexToExecute; ++i)
+        {
+            if (intervals[i].SELL.active)
+            {
+                indicesToExecute.insert(indicesToExecute.begin(), i);
+            }
+        }
+    }
+
+    for (const int index : indicesToExecute)
+    {
+        auto& interval = intervals[index];
+
+        interval.SELL.active = false;
+        interval.SELL.crossed = false;
+
+        interval.BUY.active = true;
+        interval.BUY.crossed = false;
+    }
+
+    if (!indicesToExecute.empty() && !stockState.isStaticIntervals)
+    {
+        CorrectBadSellIfRequired(stockState, indicesToExecute);
+    }
+
+    return indicesToExecute;
+}
+
+void UpdateRealizedPnL(
+    DecimalStockState& stockState,
+    const vector<int>& executedIndices,
+    const string& orderSide,
+    Decimal price
+)
+{
+    if (executedIndices.empty())
+    {
+        return;
+    }
+
+    stockState.realizedPnL -=
+        GetDecimal(executedIndices.size() * stockState.sharesPerInterval) *
+        stockState.brokerageTradingCostPerShare;
+
+    for (const int index : executedIndices)
+    {
+        auto& interval = stockState.intervals[index];
+
+        if (interval.type == IntervalType::LONG)
+        {
+            if (orderSide == "BUY")
+            {
+                interval.SELL.boughtAtPrice = price;
+            }
+            else
+            {
+                stockState.realizedPnL += GetDecimal(stockState.sharesPerInterval) *
+                                          (price - interval.SELL.boughtAtPrice.value());
+            }
+        }
+
+        if (interval.type == IntervalType::SHORT)
+        {
+            if (orderSide == "SELL")
+            {
+                interval.BUY.soldAtPrice = price;
+            }
+            else
+            {
+                stockState.realizedPnL += GetDecimal(stockState.sharesPerInterval) *
+                                          (interval.BUY.soldAtPrice.value() - price);
+            }
+        }
+    }
+}
+
+void TrackPercentageProfit(
+    const DecimalStockState& stockState,
+    const Decimal& threshold,
+    bool& reached,
+    Decimal& maxLossWhenReached
+)
+{
+    if (!reached && stockState.exitPnLAsPercentage >= threshold)
+    {
+        reached = true;
+        maxLossWhenReached = stockState.maxMovingLossAsPercentage;
+    }
+}
+
+void UpdateExitPnL(DecimalStockState& stockState)
+{
+    if (stockState.position == 0)
+    {
+        return;
+    }
+
+    Decimal exitPnL = stockState.realizedPnL;
+    exitPnL -=
+        GetDecimal(stockState.position) * stockState.brokerageTradingCostPerShare;
+
+    for (const auto& interval : stockState.intervals)
+    {
+        if (interval.type == IntervalType::LONG && interval.SELL.active)
+        {
+            exitPnL += GetDecimal(stockState.sharesPerInterval) *
+                       (stockState.lastBid - interval.SELL.boughtAtPrice.value());
+        }
+
+        if (interval.type == IntervalType::SHORT && interval.BUY.active)
+        {
+            exitPnL += GetDecimal(stockState.sharesPerInterval) *
+                       (interval.BUY.soldAtPrice.value() - stockState.lastAsk);
+        }
+    }
+
+    stockState.exitPnL = exitPnL;
+
+    const auto percentage_denominator =
+        GetDecimal(stockState.targetPosition + stockState.sharesPerInterval) *
+        stockState.initialPrice;
+
+    stockState.exitPnLAsPercentage = (exitPnL / percentage_denominator) * 100;
+
+    if (stockState.exitPnLAsPercentage > stockState.maxMovingProfitAsPercentage)
+    {
+        stockState.maxMovingProfitAsPercentage = stockState.exitPnLAsPercentage;
+    }
+
+    if (stockState.exitPnLAsPercentage < stockState.maxMovingLossAsPercentage)
+    {
+        stockState.maxMovingLossAsPercentage = stockState.exitPnLAsPercentage;
+    }
+
+    TrackPercentageProfit(
+        stockState,
+        GetDecimal(1.0),
+        stockState.reached_1_percentage_profit,
+        stockState.max_loss_when_reached_1_percentage_profit
+    );
+
+    TrackPercentageProfit(
+        stockState,
+        GetDecimal(0.75),
+        stockState.reached_0_75_percentage_profit,
+        stockState.max_loss_when_reached_0_75_percentage_profit
+    );
+
+    TrackPercentageProfit(
+        stockState,
+        GetDecimal(0.5),
+        stockState.reached_0_5_percentage_profit,
+        stockState.max_loss_when_reached_0_5_percentage_profit
+    );
+
+    TrackPercentageProfit(
+        stockState,
+        GetDecimal(0.25),
+        stockState.reached_0_25_percentage_profit,
+        stockState.max_loss_when_reached_0_25_percentage_profit
+    );
+}
+
+void ReconcileStockPositionOnSnapshot(
+    DecimalStockState& stockState, const DecimalSnapshot& snapshot
+)
+{
+    if ((snapshot.ask - snapshot.bid) >= stockState.spaceBetweenIntervals ||
+        !snapshot.bid || !snapshot.ask)
+    {
+        return;
+    }
+
+    const bool isSnapshotChanged = !stockState.lastAsk || !stockState.lastBid ||
+                                   stockState.lastAsk != snapshot.ask ||
+                                   stockState.lastBid != snapshot.bid;
+    if (isSnapshotChanged)
+    {
+        stockState.lastAsk = snapshot.ask;
+        stockState.lastBid = snapshot.bid;
+        UpdateExitPnL(stockState);
+    }
+
+    CheckCrossings(stockState, snapshot);
+
+    vector<int> indicesToExecute = GetNumToBuy(stockState, snapshot);
+    const int numToBuy = indicesToExecute.size();
+
+    int numToSell = 0;
+    if (numToBuy == 0)
+    {
+        indicesToExecute = GetNumToSell(stockState, snapshot);
+        numToSell = indicesToExecute.size();
+    }
+
+    if (numToBuy > 0 || numToSell > 0)
+    {
+        const string orderSide = numToBuy > 0 ? "BUY" : "SELL";
+        const Decimal price = numToBuy > 0 ? snapshot.ask : snapshot.bid;
+
+        const int previousPosition = stockState.position;
+        stockState.position +=
+            stockState.sharesPerInterval * (numToBuy > 0 ? numToBuy : -numToSell);
+
+        stockState.tradingLogs.push_back(DecimalTradingLog{
+            snapshot.timestamp, orderSide, price, previousPosition, stockState.position
+        });
+
+        UpdateRealizedPnL(stockState, indicesToExecute, orderSide, price);
+
+        CheckCrossings(stockState, snapshot);
+    }
+
+    if (isSnapshotChanged)
+    {
+        stockState.lastAsk = snapshot.ask;
+        stockState.lastBid = snapshot.bid;
+        UpdateExitPnL(stockState);
+    }
+}
+
+struct ParityReport
+{
+    vector<string> mismatches;
+    int divergedAtSnapshot = -1;
+};
+
+void CompareValue(
+    ParityReport& report,
+    const string& name,
+    const FixedPrice& fixed,
+    const Decimal& decimal,
+    int64_t toleranceTicks
+)
+{
+    const int64_t decimal_ticks = ToTicks(decimal);
+    if (abs(fixed.ticks - decimal_ticks) > toleranceTicks)
+    {
+        report.mismatches.push_back(
+            format("{}: fixed={} decimal={}", name, fixed.str(), decimal.str())
+        );
+    }
+}
+
+void CompareFlag(ParityReport& report, const string& name, bool fixed, bool decimal)
+{
+    if (fixed != decimal)
+    {
+        report.mismatches.push_back(
+            format("{}: fixed={} decimal={}", name, fixed, decimal)
+        );
+    }
+}
+
+// Percentages are rounded to the nearest tick by the FixedPrice engine, so they may
+// be one tick away from the 12-digit reference; prices and PnL must match exactly.
+const int64_t PERCENTAGE_TOLERANCE_TICKS = 1;
+
+bool IsSameOptionalPrice(
+    const std::optional<FixedPrice>& fixed, const std::optional<Decimal>& decimal
+)
+{
+    if (fixed.has_value() != decimal.has_value())
+    {
+        return false;
+    }
+
+    return !fixed.has_value() || fixed.value().ticks == ToTicks(decimal.value());
+}
+
+void CompareIntervals(
+    ParityReport& report, const StockState& fixed, const DecimalStockState& decimal
+)
+{
+    const auto fixed_intervals = GetSmoothingIntervals(fixed.intervals);
+    if (fixed_intervals.size() != decimal.intervals.size())
+    {
+        report.mismatches.push_back(format(
+            "intervals.size: fixed={} decimal={}",
+            fixed_intervals.size(),
+            decimal.intervals.size()
+        ));
+
+        return;
+    }
+
+    for (size_t i = 0; i < fixed_intervals.size(); ++i)
+    {
+        const auto& fixed_interval = fixed_intervals[i];
+        const auto& decimal_interval = decimal.intervals[i];
+
+        if (fixed_interval.BUY.active != decimal_interval.BUY.active ||
+            fixed_interval.BUY.crossed != decimal_interval.BUY.crossed ||
+            fixed_interval.SELL.active != decimal_interval.SELL.active ||
+            fixed_interval.SELL.crossed != decimal_interval.SELL.crossed ||
+            fixed_interval.BUY.price.ticks != ToTicks(decimal_interval.BUY.price) ||
+            fixed_interval.SELL.price.ticks != ToTicks(decimal_interval.SELL.price) ||
+            !IsSameOptionalPrice(
+                fixed_interval.SELL.boughtAtPrice, decimal_interval.SELL.boughtAtPrice
+            ) ||
+            !IsSameOptionalPrice(
+                fixed_interval.BUY.soldAtPrice, decimal_interval.BUY.soldAtPrice
+            ))
+        {
+            report.mismatches.push_back(format(
+                "intervals[{}]: fixed=(BUY {} {}{} SELL {} {}{}) "
+                "decimal=(BUY {} {}{} SELL {} {}{})",
+                i,
+                fixed_interval.BUY.price.str(),
+                fixed_interval.BUY.active ? "A" : "-",
+                fixed_interval.BUY.crossed ? "C" : "-",
+                fixed_interval.SELL.price.str(),
+                fixed_interval.SELL.active ? "A" : "-",
+                fixed_interval.SELL.crossed ? "C" : "-",
+                decimal_interval.BUY.price.str(),
+                decimal_interval.BUY.active ? "A" : "-",
+                decimal_interval.BUY.crossed ? "C" : "-",
+                decimal_interval.SELL.price.str(),
+                decimal_interval.SELL.active ? "A" : "-",
+                decimal_interval.SELL.crossed ? "C" : "-"
+            ));
+
+            return;
+        }
+    }
+}
+
+void CompareStates(
+    ParityReport& report, const StockState& fixed, const DecimalStockState& decimal
+)
+{
+    if (fixed.tradingLogs.size() != decimal.tradingLogs.size())
+    {
+        report.mismatches.push_back(format(
+            "tradingLogs.size: fixed={} decimal={}",
+            fixed.tradingLogs.size(),
+            decimal.tradingLogs.size()
+        ));
+    }
+
+    const size_t num_logs = min(fixed.tradingLogs.size(), decimal.tradingLogs.size());
+    for (size_t i = 0; i < num_logs; ++i)
+    {
+        const auto& fixed_log = fixed.tradingLogs[i];
+        const auto& decimal_log = decimal.tradingLogs[i];
+
+        if (fixed_log.timeStamp != decimal_log.timeStamp ||
+            fixed_log.action != decimal_log.action ||
+            fixed_log.price.ticks != ToTicks(decimal_log.price) ||
+            fixed_log.previousPosition != decimal_log.previousPosition ||
+            fixed_log.newPosition != decimal_log.newPosition)
+        {
+            report.mismatches.push_back(format(
+                "tradingLogs[{}]: fixed=({} {} {} {}->{}) decimal=({} {} {} {}->{})",
+                i,
+                FormatEasternTimestamp(fixed_log.timeStamp),
+                fixed_log.action,
+                fixed_log.price.str(),
+                fixed_log.previousPosition,
+                fixed_log.newPosition,
+                FormatEasternTimestamp(decimal_log.timeStamp),
+                decimal_log.action,
+                decimal_log.price.str(),
+                decimal_log.previousPosition,
+                decimal_log.newPosition
+            ));
+
+            break;
+        }
+    }
+
+    CompareIntervals(report, fixed, decimal);
+
+    CompareValue(report, "realizedPnL", fixed.realizedPnL, decimal.realizedPnL, 0);
+    CompareValue(report, "exitPnL", fixed.exitPnL, decimal.exitPnL, 0);
+
+    CompareValue(
+        report,
+        "exitPnLAsPercentage",
+        fixed.exitPnLAsPercentage,
+        decimal.exitPnLAsPercentage,
+        PERCENTAGE_TOLERANCE_TICKS
+    );
+
+    CompareValue(
+        report,
+        "maxMovingProfitAsPercentage",
+        fixed.maxMovingProfitAsPercentage,
+        decimal.maxMovingProfitAsPercentage,
+        PERCENTAGE_TOLERANCE_TICKS
+    );
+
+    CompareValue(
+        report,
+        "maxMovingLossAsPercentage",
+        fixed.maxMovingLossAsPercentage,
+        decimal.maxMovingLossAsPercentage,
+        PERCENTAGE_TOLERANCE_TICKS
+    );
+
+    CompareFlag(
+        report,
+        "reached_1_percentage_profit",
+        fixed.reached_1_percentage_profit,
+        decimal.reached_1_percentage_profit
+    );
+
+    CompareFlag(
+        report,
+        "reached_0_75_percentage_profit",
+        fixed.reached_0_75_percentage_profit,
+        decimal.reached_0_75_percentage_profit
+    );
+
+    CompareFlag(
+        report,
+        "reached_0_5_percentage_profit",
+        fixed.reached_0_5_percentage_profit,
+        decimal.reached_0_5_percentage_profit
+    );
+
+    CompareFlag(
+        report,
+        "reached_0_25_percentage_profit",
+        fixed.reached_0_25_percentage_profit,
+        decimal.reached_0_25_percentage_profit
+    );
+}
+
+// First snapshot (counting every second of a collapsed quote) after which the two
+// engines hold different positions, or -1.
+int FindDivergedSnapshot(
+    const std::string& stock,
+    StockState fixed_state,
+    DecimalStockState decimal_state,
+    std::span<const Snapshot> snapshots
+)
+{
+    int i = 0;
+    for (const Snapshot& run : snapshots)
+    {
+        for (int repeat = 0; repeat < run.repeatCount; ++repeat, ++i)
+        {
+            const Snapshot snapshot = GetRepeatedSnapshot(run, repeat);
+
+            ::ReconcileStockPositionOnSnapshot(stock, fixed_state, snapshot);
+
+            const DecimalSnapshot decimal_snapshot{
+                ToDecimal(snapshot.ask), ToDecimal(snapshot.bid), snapshot.timestamp
+            };
+            ReconcileStockPositionOnSnapshot(decimal_state, decimal_snapshot);
+
+            if (fixed_state.position != decimal_state.position)
+            {
+                return i;
+            }
+        }
+    }
+
+    return -1;
+}
+
+// The FixedPrice side runs through SimulateDay with the dataset's blocks, the way
+// backtests do, so the quiet-band fast path and the repeat shortcut are checked too.
+ParityReport RunStockParity(const std::string& stock, const StockState& state)
+{
+    StockState fixed_state = state;
+    DecimalStockState decimal_state = ToDecimalStockState(state);
+
+    const auto dataset = GetSnapshotDataset(state);
+    const auto& snapshots = dataset->snapshots;
+
+    SimulateDay(stock, fixed_state, snapshots, &dataset->blocks);
+
+    // Every second of a collapsed quote is replayed: the decimal reference has no
+    // shortcut for repeats.
+    for (const Snapshot& run : snapshots)
+    {
+        for (int repeat = 0; repeat < run.repeatCount; ++repeat)
+        {
+            const Snapshot snapshot = GetRepeatedSnapshot(run, repeat);
+
+            const DecimalSnapshot decimal_snapshot{
+                ToDecimal(snapshot.ask), ToDecimal(snapshot.bid), snapshot.timestamp
+            };
+            ReconcileStockPositionOnSnapshot(decimal_state, decimal_snapshot);
+        }
+    }
+
+    ParityReport report{};
+    CompareStates(report, fixed_state, decimal_state);
+
+    if (!report.mismatches.empty())
+    {
+        report.divergedAtSnapshot = FindDivergedSnapshot(
+            stock, state, ToDecimalStockState(state), snapshots
+        );
+    }
+
+    return report;
+}
+
+// Prints the mismatches, if any, and returns whether there were.
+bool CheckStockParity(const std::string& stock, const StockState& state)
+{
+    const ParityReport report = RunStockParity(stock, state);
+    if (report.mismatches.empty())
+    {
+        return false;
+    }
+
+    string message = format("Decimal parity mismatch for {} on {}", stock, state.date);
+
+    if (report.divergedAtSnapshot >= 0)
+    {
+        message +=
+            format(" (positions diverged at snapshot {})", report.divergedAtSnapshot);
+    }
+
+    for (const auto& mismatch : report.mismatches)
+    {
+        message += format("\n    {}", mismatch);
+    }
+
+    Print(message);
+
+    return true;
+}
+}  // namespace
+
+void RunDecimalParityCpp(
+    const std::vector<std::unordered_map<std::string, StockState>>& states_list
+)
+{
+    vector<pair<const string*, const StockState*>> stockDays;
+    for (const auto& states : states_list)
+    {
+        for (const auto& [stock, state] : states)
+        {
+            stockDays.emplace_back(&stock, &state);
+        }
+    }
+
+    const int num_stocks = static_cast<int>(stockDays.size());
+
+    atomic<int> num_mismatched_stocks{0};
+    RunOnWorkerPool(
+        stockDays.size(),
+        [&](size_t i)
+        {
+            if (CheckStockParity(*stockDays[i].first, *stockDays[i].second))
+            {
+                num_mismatched_stocks++;
+            }
+        }
+    );
+
+    Print(format(
+        "Decimal parity over {} dates: {} of {} stock-days differ between FixedPrice "
+        "({} decimals) and cpp_dec_float<{}>",
+        states_list.size(),
+        num_mismatched_stocks.load(),
+        num_stocks,
+        kFixedPriceDecimals,
+        kDecimalPrecision
+    ));
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+bool IsDecimalParity();
+
+void RunDecimalParityCpp(
+    const std::vector<std::unordered_map<std::string, StockState>>& states_list
+);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+using PhiloxCounter = std::array<uint32_t, 4>;
+using PhiloxKey = std::array<uint32_t, 2>;
+
+const uint64_t kPhiloxMultiplier0 = 0xD2511F53;
+const uint64_t kPhiloxMultiplier1 = 0xCD9E8D57;
+const uint32_t kPhiloxKeyIncrement0 = 0x9E3779B9;
+const uint32_t kPhiloxKeyIncrement1 = 0xBB67AE85;
+const int kPhiloxRounds = 10;
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"): a
+// keyed bijection on 128-bit counters. Encrypting 0, 1, 2, ... gives a stream whose
+// n-th block is computed directly, with no state to carry or share between threads,
+// and each key gives an independent stream.
+inline PhiloxCounter Philox4x32(PhiloxCounter counter, PhiloxKey key)
+{
+    for (int round = 0; round < kPhiloxRounds; ++round)
+    {
+        const uint64_t product0 = kPhiloxMultiplier0 * counter[0];
+        const uint64_t product1 = kPhiloxMultiplier1 * counter[2];
+
+        counter = {
+            static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+            static_cast<uint32_t>(product1),
+            static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+            static_cast<uint32_t>(product0)
+        };
+
+        key[0] += kPhiloxKeyIncrement0;
+        key[1] += kPhiloxKeyIncrement1;
+    }
+
+    return counter;
+}
+
+// Philox4x32 of the counters {firstBlock + lane, path} for kNumLanes lanes at once:
+// out[lane] matches Philox4x32 of that counter. The words are kept lane by lane so
+// every round is the same arithmetic across a row of lanes, which compiles to vector
+// multiplies and xors.
+template <size_t kNumLanes>
+void Philox4x32Lanes(
+    uint64_t firstBlock,
+    uint64_t path,
+    PhiloxKey key,
+    std::array<PhiloxCounter, kNumLanes>& out
+)
+{
+    uint32_t words0[kNumLanes];
+    uint32_t words1[kNumLanes];
+    uint32_t words2[kNumLanes];
+    uint32_t words3[kNumLanes];
+
+    for (size_t lane = 0; lane < kNumLanes; ++lane)
+    {
+        const uint64_t block = firstBlock + lane;
+        words0[lane] = static_cast<uint32_t>(block);
+        words1[lane] = static_cast<uint32_t>(block >> 32);
+        words2[lane] = static_cast<uint32_t>(path);
+        words3[lane] = static_cast<uint32_t>(path >> 32);
+    }
+
+    for (int round = 0; round < kPhiloxRounds; ++round)
+    {
+        for (size_t lane = 0; lane < kNumLanes; ++lane)
+        {
+            const uint64_t product0 = kPhiloxMultiplier0 * words0[lane];
+            const uint64_t product1 = kPhiloxMultiplier1 * words2[lane];
+
+            const uint32_t high0 = static_cast<uint32_t>(product0 >> 32);
+            const uint32_t high1 = static_cast<uint32_t>(product1 >> 32);
+
+            words0[lane] = high1 ^ words1[lane] ^ key[0];
+            words1[lane] = static_cast<uint32_t>(product1);
+            words2[lane] = high0 ^ words3[lane] ^ key[1];
+            words3[lane] = static_cast<uint32_t>(product0);
+        }
+
+        key[0] += kPhiloxKeyIncrement0;
+        key[1] += kPhiloxKeyIncrement1;
+    }
+
+    for (size_t lane = 0; lane < kNumLanes; ++lane)
+    {
+        out[lane] = {words0[lane], words1[lane], words2[lane], words3[lane]};
+    }
+}
@@ -1,5 +1,6 @@
 #include "price_simulator.hpp"
 
+#include <array>
 #include <filesystem>
 #include <format>
 #include <fstream>
@@ -7,6 +8,13 @@
 #include <random>
 #include <shared_mutex>
 
+#include "dataset_manifest.hpp"
+#include "numeric_conversions.hpp"
+#include "snapshot_cache.hpp"
+#include "repeated_quotes.hpp"
+#include "snapshot_file.hpp"
+#include "timestamp.hpp"
+
 using namespace std;
 using json = nlohmann::json;
 
@@ -31,155 +39,471 @@ bool IsHistoricalSnapshot() { return IsTruthyEnv("HISTORICAL_SNAPSHOT"); }
 
 bool IsLiveTrading() { return !IsRandomSnapshot() && !IsHistoricalSnapshot(); }
 
-const Decimal INITIAL_PRICE = GetDecimal(9.0);
-Decimal randomPrice = INITIAL_PRICE;
+SnapshotSource GetSnapshotSource()
+{
+    if (IsRandomSnapshot())
+    {
+        return SnapshotSource::RANDOM;
+    }
+
+    if (IsHistoricalSnapshot())
+    {
+        return SnapshotSource::HISTORICAL;
+    }
+
+    return SnapshotSource::LIVE;
+}
+
+const FixedPrice INITIAL_PRICE = FixedPrice::FromDouble(9.0);
+const FixedPrice RANDOM_TICK = FixedPrice::FromDouble(0.01);
+const int kRandomTicksPerBlock = 64;
+// A tick is down with probability 0.49: a 32-bit draw at or below 0.49 * 2^32.
+const uint32_t kTickDownThreshold = 2104533975;
 
-Decimal GetRandomPrice()
+uint64_t GetRandomSeed()
 {
-    Decimal tickDown = randomPrice - GetDecimal(0.01);
-    Decimal tickUp = randomPrice + GetDecimal(0.01);
+    static const uint64_t seed = []() -> uint64_t
+    {
+        const char* seedStr = getenv("RANDOM_SEED");
+        if (seedStr != nullptr)
+        {
+            return stoull(seedStr);
+        }
 
-    mt19937 random_engine{random_device{}()};
-    uniform_real_distribution<> distribution{0.0, 1.0};
+        random_device device;
+        const uint64_t seed = (static_cast<uint64_t>(device()) << 32) | device();
+        Print(format("Random snapshots seeded with RANDOM_SEED={}", seed));
 
-    Decimal probabilityOfTickDown = GetDecimal(distribution(random_engine));
+        return seed;
+    }();
 
-    randomPrice = (probabilityOfTickDown <= GetDecimal(0.49)) ? tickDown : tickUp;
+    return seed;
+}
 
-    return randomPrice;
+void SeedRandomWalk(StockState& stock_state, const std::string& stock, uint64_t path)
+{
+    uint64_t hash = kFnvOffsetBasis;
+    HashInteger(hash, static_cast<int64_t>(GetRandomSeed()));
+    for (const char c : stock)
+    {
+        HashInteger(hash, c);
+    }
+    HashInteger(hash, 0);  // keeps ("AB", "C...") apart from ("A", "BC...")
+    for (const char c : stock_state.date)
+    {
+        HashInteger(hash, c);
+    }
+
+    RandomWalk& walk = stock_state.randomWalk;
+    walk.isSeeded = true;
+    walk.key = {static_cast<uint32_t>(hash), static_cast<uint32_t>(hash >> 32)};
+    walk.path = path;
+    walk.block = 0;
+    walk.price = INITIAL_PRICE;
+    walk.numBufferedTicks = 0;
 }
 
-Snapshot GetRandomSnapshot()
+void BufferRandomTicks(RandomWalk& walk)
 {
-    Snapshot snapshot{};
+    if (!walk.isSeeded)
+    {
+        throw exception("Random snapshots requested before SeedRandomWalk");
+    }
+
+    array<PhiloxCounter, kRandomTicksPerBlock / 4> draws;
+    Philox4x32Lanes(walk.block, walk.path, walk.key, draws);
+    walk.block += draws.size();
+
+    uint64_t tickDowns = 0;
+    for (int i = 0; i < kRandomTicksPerBlock; ++i)
+    {
+        const uint64_t isTickDown = draws[i / 4][i % 4] <= kTickDownThreshold;
+        tickDowns |= isTickDown << i;
+    }
+
+    walk.tickDowns = tickDowns;
+    walk.numBufferedTicks = kRandomTicksPerBlock;
+}
+
+Snapshot GetRandomSnapshot(RandomWalk& walk)
+{
+    if (walk.numBufferedTicks == 0)
+    {
+        BufferRandomTicks(walk);
+    }
+
+    const bool isTickDown = walk.tickDowns & 1;
+    walk.tickDowns >>= 1;
+    walk.numBufferedTicks--;
 
-    auto random_price = GetRandomPrice();
+    walk.price = isTickDown ? walk.price - RANDOM_TICK : walk.price + RANDOM_TICK;
 
-    snapshot.ask = random_price;
-    snapshot.bid = random_price - Decimal(GetDecimal(0.01));
+    Snapshot snapshot{};
+    snapshot.ask = walk.price;
+    snapshot.bid = walk.price - RANDOM_TICK;
 
     return snapshot;
 }
 
-void RestartRandomPrice() { randomPrice = INITIAL_PRICE; }
+void GetRandomSnapshots(RandomWalk& walk, std::span<Snapshot> snapshots)
+{
+    for (Snapshot& snapshot : snapshots)
+    {
+        snapshot = GetRandomSnapshot(walk);
+    }
+}
+
+void RestartRandomPrice(RandomWalk& walk)
+{
+    walk.path++;
+    walk.block = 0;
+    walk.price = INITIAL_PRICE;
+    walk.numBufferedTicks = 0;
+}
 
 void DeleteHistoricalSnapshots(StockState& stock_state)
 {
-    delete stock_state.historicalSnapshots.data;
+    stock_state.historicalSnapshots.data.reset();
+    stock_state.historicalSnapshots.blocks.reset();
 }
 
-string GetFilePathForStockDataOnDate(const StockState& stock_state)
+std::string GetHistoricalDataRootPath()
 {
     const string cwd = filesystem::current_path().string();
+
+    return format("{}\\..\\deephedge\\historical-data-80", cwd);
+}
+
+string GetFilePathForStockDataOnDate(
+    const StockState& stock_state, const string& extension
+)
+{
     const string year = string_split(stock_state.date, '-')[0];
     const string month = string_split(stock_state.date, '-')[1];
 
     return format(
-        "{}\\..\\deephedge\\historical-data-80\\{}\\{}\\{}\\{}.json",
-        cwd,
+        "{}\\{}\\{}\\{}\\{}{}",
+        GetHistoricalDataRootPath(),
         year,
         month,
         stock_state.date,
-        stock_state.brokerageId
+        stock_state.brokerageId,
+        extension
     );
 }
 
-void WritePnLAsPercentagesToSnapshotsFile(const StockState& stock_state)
+string GetFilePathForStockDataOnDate(const StockState& stock_state)
+{
+    return GetFilePathForStockDataOnDate(stock_state, ".json");
+}
+
+vector<Snapshot> GetSnapshotsForStockOnDate(const StockState& stock_state)
 {
-    string file_path = GetFilePathForStockDataOnDate(stock_state);
+    const string binary_file_path = GetFilePathForStockDataOnDate(stock_state, ".bin");
+    const string json_file_path = GetFilePathForStockDataOnDate(stock_state);
+    if (IsBinarySnapshotFileCurrent(binary_file_path, json_file_path))
+    {
+        return ReadSnapshotsBinaryFile(binary_file_path);
+    }
 
-    try
+    if (filesystem::exists(binary_file_path))
     {
-        std::ifstream file(file_path);
-        if (!file.is_open())
+        Print(format("{} is older than its JSON, reading the JSON", binary_file_path));
+    }
+
+    // The manifest, when there is one, saves counting the snapshots before parsing.
+    const DatasetManifestEntry* entry =
+        FindDatasetManifestEntry(stock_state.date, stock_state.brokerageId);
+
+    return ReadSnapshotsJsonFile(
+        json_file_path, entry != nullptr ? entry->numSnapshots : 0
+    );
+}
+
+// The engine steps through rows of {ask, bid, timestamp} and the cache collapses
+// repeated quotes in place, so the file's columns are transposed once into the
+// vector the dataset keeps; the mapping is released when this returns.
+std::vector<Snapshot> ReadSnapshotsBinaryFile(const std::string& file_path)
+{
+    auto file = MapFile(file_path);
+
+    vector<Snapshot> snapshots;
+
+    if (GetSnapshotFileVersion(*file, file_path) == kCompressedSnapshotFileVersion)
+    {
+        const auto snapshot_file =
+            MapCompressedSnapshotFile(std::move(file), file_path);
+        DecodeSnapshotFile(snapshot_file, snapshots);
+
+        return snapshots;
+    }
+
+    const auto snapshot_file = MapSnapshotFile(std::move(file), file_path);
+    const auto& columns = snapshot_file.columns;
+
+    snapshots.resize(columns.asks.size());
+    for (size_t i = 0; i < snapshots.size(); ++i)
+    {
+        snapshots[i].ask = FixedPrice::FromTicks(columns.asks[i]);
+        snapshots[i].bid = FixedPrice::FromTicks(columns.bids[i]);
+        snapshots[i].timestamp = columns.timestamps[i];
+    }
+
+    return snapshots;
+}
+
+// Fills `snapshots` from the "snapshots" array of a snapshots file as the parser
+// walks it, without building a DOM. Every other key (ticker, the max_moving_* and
+// reached_* results written back after a backtest, ...) is skipped.
+struct SnapshotsSaxHandler
+{
+    enum class Field
+    {
+        NONE,
+        ASK,
+        BID,
+        TIMESTAMP
+    };
+
+    static const int kSnapshotsArrayDepth = 2;
+    static const int kSnapshotDepth = 3;
+
+    vector<Snapshot>& snapshots;
+    int depth = 0;
+    bool isSnapshotsKey = false;
+    bool isInSnapshots = false;
+    Field field = Field::NONE;
+    int numFieldsSet = 0;
+    std::string error{};
+
+    bool IsSnapshotValue() const { return isInSnapshots && depth == kSnapshotDepth; }
+
+    bool SetNumber(const FixedPrice& value)
+    {
+        if (!IsSnapshotValue() || field == Field::NONE)
         {
-            throw exception(format("Error: Unable to open file {}", file_path).c_str());
+            return true;
         }
 
-        json json_data;
-        file >> json_data;
+        if (field == Field::TIMESTAMP)
+        {
+            return Fail("timestamp is not a string");
+        }
 
-        json_data["max_moving_profit_as_percentage"] =
-            stock_state.maxMovingProfitAsPercentage.convert_to<double>();
+        auto& price = field == Field::ASK ? snapshots.back().ask : snapshots.back().bid;
+        price = value;
 
-        json_data["max_moving_loss_as_percentage"] =
-            stock_state.maxMovingLossAsPercentage.convert_to<double>();
+        numFieldsSet++;
+        field = Field::NONE;
 
-        json_data["reached_1_percentage_profit"] =
-            stock_state.reached_1_percentage_profit;
-        json_data["max_loss_when_reached_1_percentage_profit"] =
-            stock_state.max_loss_when_reached_1_percentage_profit.convert_to<double>();
+        return true;
+    }
 
-        json_data["reached_0_75_percentage_profit"] =
-            stock_state.reached_0_75_percentage_profit;
-        json_data["max_loss_when_reached_0_75_percentage_profit"] =
-            stock_state.max_loss_when_reached_0_75_percentage_profit.convert_to<double>(
-            );
+    bool SetNonNumber()
+    {
+        if (IsSnapshotValue() && field != Field::NONE)
+        {
+            return Fail("ask, bid or timestamp has the wrong type");
+        }
 
-        json_data["reached_0_5_percentage_profit"] =
-            stock_state.reached_0_5_percentage_profit;
-        json_data["max_loss_when_reached_0_5_percentage_profit"] =
-            stock_state.max_loss_when_reached_0_5_percentage_profit.convert_to<double>(
-            );
+        return true;
+    }
 
-        json_data["reached_0_25_percentage_profit"] =
-            stock_state.reached_0_25_percentage_profit;
-        json_data["max_loss_when_reached_0_25_percentage_profit"] =
-            stock_state.max_loss_when_reached_0_25_percentage_profit.convert_to<double>(
-            );
+    bool Fail(const std::string& message)
+    {
+        error = format("Invalid snapshot {}: {}", snapshots.size() - 1, message);
+        return false;
+    }
 
-        std::ofstream out_file(file_path);
-        out_file << json_data.dump();
+    bool null() { return SetNonNumber(); }
+
+    bool boolean(bool) { return SetNonNumber(); }
+
+    bool number_integer(json::number_integer_t value)
+    {
+        return SetNumber(FixedPrice::FromDouble(static_cast<double>(value)));
     }
-    catch (const json::parse_error& e)
+
+    bool number_unsigned(json::number_unsigned_t value)
     {
-        throw exception(format("JSON parse error: {}", e.what()).c_str());
+        return SetNumber(FixedPrice::FromDouble(static_cast<double>(value)));
     }
-    catch (const std::exception& e)
+
+    // Parsed from the number's text so that e.g. 9.37 lands on its exact tick
+    // rather than on the nearest double.
+    bool number_float(json::number_float_t, const json::string_t& text)
     {
-        throw exception(format("Error writing pnl to snapshots: {}", e.what()).c_str());
+        FixedPrice value{};
+        const bool isPrice = field == Field::ASK || field == Field::BID;
+        if (IsSnapshotValue() && isPrice && !TryParseFixedPrice(text, value))
+        {
+            return Fail(format("price {} is out of range", text));
+        }
+
+        return SetNumber(value);
     }
+
+    bool string(json::string_t& value)
+    {
+        if (!IsSnapshotValue() || field == Field::NONE)
+        {
+            return true;
+        }
+
+        if (field != Field::TIMESTAMP)
+        {
+            return Fail("ask or bid is not a number");
+        }
+
+        if (!TryParseEasternTimestamp(value, snapshots.back().timestamp))
+        {
+            return Fail(format("invalid timestamp \"{}\"", value));
+        }
+
+        numFieldsSet++;
+        field = Field::NONE;
+
+        return true;
+    }
+
+    bool binary(json::binary_t&) { return SetNonNumber(); }
+
+    bool start_object(size_t)
+    {
+        if (!SetNonNumber())
+        {
+            return false;
+        }
+
+        depth++;
+
+        if (isInSnapshots && depth == kSnapshotDepth)
+        {
+            snapshots.emplace_back();
+            numFieldsSet = 0;
+        }
+
+        return true;
+    }
+
+    bool end_object()
+    {
+        if (isInSnapshots && depth == kSnapshotDepth && numFieldsSet != 3)
+        {
+            return Fail("missing ask, bid or timestamp");
+        }
+
+        depth--;
+        field = Field::NONE;
+
+        return true;
+    }
+
+    bool start_array(size_t)
+    {
+        if (!SetNonNumber())
+        {
+            return false;
+        }
+
+        depth++;
+
+        if (isSnapshotsKey && depth == kSnapshotsArrayDepth)
+        {
+            isInSnapshots = true;
+        }
+        isSnapshotsKey = false;
+
+        return true;
+    }
+
+    bool end_array()
+    {
+        if (isInSnapshots && depth == kSnapshotsArrayDepth)
+        {
+            isInSnapshots = false;
+        }
+
+        depth--;
+        field = Field::NONE;
+
+        return true;
+    }
+
+    bool key(json::string_t& name)
+    {
+        isSnapshotsKey = depth == 1 && name == "snapshots";
+
+        field = Field::NONE;
+        if (isInSnapshots && depth == kSnapshotDepth)
+        {
+            if (name == "ask")
+            {
+                field = Field::ASK;
+            }
+            else if (name == "bid")
+            {
+                field = Field::BID;
+            }
+            else if (name == "timestamp")
+            {
+                field = Field::TIMESTAMP;
+            }
+        }
+
+        return true;
+    }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception& e)
+    {
+        error = format("JSON parse error: {}", e.what());
+        return false;
+    }
+};
+
+// One snapshot per "ask" key; an upper bound if other keys contain the same text.
+size_t CountSnapshots(string_view text)
+{
+    size_t count = 0;
+    for (size_t position = text.find("\"ask\""); position != string_view::npos;
+         position = text.find("\"ask\"", position + 5))
+    {
+        count++;
+    }
+
+    return count;
 }
 
-vector<Snapshot>* GetSnapshotsForStockOnDate(const StockState& stock_state)
+std::vector<Snapshot> ReadSnapshotsJsonFile(
+    const std::string& file_path, size_t numSnapshots
+)
 {
-    string file_path = GetFilePathForStockDataOnDate(stock_state);
-    vector<Snapshot>* data = new vector<Snapshot>();
+    vector<Snapshot> snapshots;
 
     try
     {
-        std::ifstream file(file_path);
+        std::ifstream file(file_path, ios::binary);
         if (!file.is_open())
         {
             throw exception(format("Error: Unable to open file {}", file_path).c_str());
         }
 
-        json json_data;
-        file >> json_data;
+        const string text{istreambuf_iterator<char>(file), istreambuf_iterator<char>()};
 
-        const auto& snapshots_json = json_data["snapshots"];
+        snapshots.reserve(numSnapshots > 0 ? numSnapshots : CountSnapshots(text));
 
-        for (const auto& snapshot_json : snapshots_json)
+        SnapshotsSaxHandler handler{snapshots};
+        if (!json::sax_parse(text, &handler))
         {
-            Snapshot snapshot{};
-
-            snapshot.ask = GetDecimal(snapshot_json["ask"].get<double>());
-            snapshot.bid = GetDecimal(snapshot_json["bid"].get<double>());
-            snapshot.timestamp = snapshot_json["timestamp"].get<std::string>();
-
-            data->push_back(snapshot);
+            throw exception(handler.error.c_str());
         }
     }
-    catch (const json::parse_error& e)
-    {
-        throw exception(format("JSON parse error: {}", e.what()).c_str());
-    }
     catch (const std::exception& e)
     {
         throw exception(format("Error reading snapshots: {}", e.what()).c_str());
     }
 
-    return data;
+    return snapshots;
 }
 
 struct StockAndDate
@@ -206,17 +530,37 @@ StockAndDate GetStockAndDate(std::string file_name)
     return StockAndDate{splitted[0], splitted[1]};
 }
 
-Snapshot GetHistoricalSnapshot(StockState& stock_state)
+void LoadHistoricalSnapshots(StockState& stock_state)
 {
     if (stock_state.historicalSnapshots.data == nullptr)
     {
-        stock_state.historicalSnapshots.data = GetSnapshotsForStockOnDate(stock_state);
+        SetHistoricalSnapshots(stock_state, GetSnapshotDataset(stock_state));
     }
+}
 
-    Snapshot snapshot =
-        stock_state.historicalSnapshots.data->at(stock_state.historicalSnapshots.index);
+void SetHistoricalSnapshots(
+    StockState& stock_state, const std::shared_ptr<const SnapshotDataset>& dataset
+)
+{
+    stock_state.historicalSnapshots.data = {dataset, &dataset->snapshots};
+    stock_state.historicalSnapshots.blocks = {dataset, &dataset->blocks};
+}
 
-    stock_state.historicalSnapshots.index++;
+Snapshot GetHistoricalSnapshot(StockState& stock_state)
+{
+    LoadHistoricalSnapshots(stock_state);
+
+    auto& historicalSnapshots = stock_state.historicalSnapshots;
+    const Snapshot& run = historicalSnapshots.data->at(historicalSnapshots.index);
+
+    const Snapshot snapshot = GetRepeatedSnapshot(run, historicalSnapshots.repeat);
+
+    historicalSnapshots.repeat++;
+    if (historicalSnapshots.repeat == run.repeatCount)
+    {
+        historicalSnapshots.repeat = 0;
+        historicalSnapshots.index++;
+    }
 
     return snapshot;
 }
@@ -225,7 +569,7 @@ Snapshot GetSimulatedSnapshot(StockState& stock_state)
 {
     if (IsRandomSnapshot())
     {
-        return GetRandomSnapshot();
+        return GetRandomSnapshot(stock_state.randomWalk);
     }
 
     if (IsHistoricalSnapshot())
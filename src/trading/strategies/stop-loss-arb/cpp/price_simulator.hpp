@@ -1,11 +1,40 @@
 #pragma once
 
+#include <span>
+
+#include "snapshot_cache.hpp"
 #include "types.hpp"
 #include "utils.hpp"
 
+bool IsTruthyEnv(const char* envName);
+
 Snapshot GetSimulatedSnapshot(StockState& stock_state);
 
-void RestartRandomPrice();
+// RANDOM_SEED, or a fresh seed printed on first use so the run can be replayed.
+uint64_t GetRandomSeed();
+
+// Starts the stock's walk at the initial price, keyed by the seed, stock and date.
+// Paths of one key are independent walks.
+void SeedRandomWalk(
+    StockState& stock_state, const std::string& stock, uint64_t path = 0
+);
+
+Snapshot GetRandomSnapshot(RandomWalk& walk);
+
+// The next snapshots.size() steps of the walk at once.
+void GetRandomSnapshots(RandomWalk& walk, std::span<Snapshot> snapshots);
+
+// Points the stock at the shared snapshots for its date, unless it already has them.
+void LoadHistoricalSnapshots(StockState& stock_state);
+
+void SetHistoricalSnapshots(
+    StockState& stock_state, const std::shared_ptr<const SnapshotDataset>& dataset
+);
+
+Snapshot GetHistoricalSnapshot(StockState& stock_state);
+
+// Back to the initial price, on the next path of the same stream.
+void RestartRandomPrice(RandomWalk& walk);
 
 bool IsRandomSnapshot();
 
@@ -13,8 +42,21 @@ bool IsHistoricalSnapshot();
 
 bool IsLiveTrading();
 
+SnapshotSource GetSnapshotSource();
+
 bool IsHistoricalSnapshotsExhausted(const StockState& stock_state);
 
-void DeleteHistoricalSnapshots(StockState& stock_state);
+// cwd\..\deephedge\historical-data-80
+std::string GetHistoricalDataRootPath();
+
+// Reads <ticker>.bin for the stock's date if it has been converted, else <ticker>.json.
+std::vector<Snapshot> GetSnapshotsForStockOnDate(const StockState& stock_state);
 
-void WritePnLAsPercentagesToSnapshotsFile(const StockState& stock_state);
+std::vector<Snapshot> ReadSnapshotsBinaryFile(const std::string& file_path);
+
+// `numSnapshots` is the expected count, if known, to size the result up front.
+std::vector<Snapshot> ReadSnapshotsJsonFile(
+    const std::string& file_path, size_t numSnapshots = 0
+);
+
+void DeleteHistoricalSnapshots(StockState& stock_state);
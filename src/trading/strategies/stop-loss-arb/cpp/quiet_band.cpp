@@ -0,0 +1,204 @@
+#include "quiet_band.hpp"
+
+#include <algorithm>
+
+#include "algo.hpp"
+#include "interval_ladder.hpp"
+#include "price_simulator.hpp"
+
+using namespace std;
+
+bool IsFastForwardDisabled()
+{
+    static const bool isFastForwardDisabled = IsTruthyEnv("NO_FAST_FORWARD");
+    return isFastForwardDisabled;
+}
+
+std::vector<SnapshotBlock> GetSnapshotBlocks(const std::vector<Snapshot>& snapshots)
+{
+    vector<SnapshotBlock> blocks;
+    blocks.reserve((snapshots.size() + kSnapshotBlockSize - 1) / kSnapshotBlockSize);
+
+    for (size_t begin = 0; begin < snapshots.size(); begin += kSnapshotBlockSize)
+    {
+        const size_t end = min(begin + kSnapshotBlockSize, snapshots.size());
+
+        SnapshotBlock block{
+            FixedPrice::Max(),
+            FixedPrice::Min(),
+            FixedPrice::Max(),
+            FixedPrice::Min(),
+            FixedPrice::Min()
+        };
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto& snapshot = snapshots[i];
+
+            block.minAsk = min(block.minAsk, snapshot.ask);
+            block.maxAsk = max(block.maxAsk, snapshot.ask);
+            block.minBid = min(block.minBid, snapshot.bid);
+            block.maxBid = max(block.maxBid, snapshot.bid);
+            block.maxSpread = max(block.maxSpread, snapshot.ask - snapshot.bid);
+        }
+
+        blocks.push_back(block);
+    }
+
+    return blocks;
+}
+
+// Whether every quote in the block leaves the ladder alone: no active BUY is crossed
+// (ask < price) or executable (ask >= price once crossed), and likewise no active SELL
+// (bid > price, or bid <= price once crossed).
+bool IsInQuietBand(const IntervalLadder& intervals, const SnapshotBlock& block)
+{
+    bool isQuiet = true;
+
+    intervals.buyActive.ForEach(
+        [&](int i)
+        {
+            const FixedPrice price = GetBuyPrice(intervals, i);
+            const bool crossed = intervals.buyCrossed.Test(i);
+
+            if (crossed ? block.maxAsk >= price : block.minAsk < price)
+            {
+                isQuiet = false;
+            }
+        }
+    );
+
+    intervals.sellActive.ForEach(
+        [&](int i)
+        {
+            const FixedPrice price = GetSellPrice(intervals, i);
+            const bool crossed = intervals.sellCrossed.Test(i);
+
+            if (crossed ? block.minBid <= price : block.maxBid > price)
+            {
+                isQuiet = false;
+            }
+        }
+    );
+
+    return isQuiet;
+}
+
+bool TryFastForwardQuietBlock(StockState& stockState)
+{
+    auto& historicalSnapshots = stockState.historicalSnapshots;
+    if (historicalSnapshots.data == nullptr || historicalSnapshots.blocks == nullptr ||
+        historicalSnapshots.repeat != 0)
+    {
+        return false;
+    }
+
+    return TryFastForwardQuietBlock(
+        stockState,
+        *historicalSnapshots.data,
+        *historicalSnapshots.blocks,
+        historicalSnapshots.index
+    );
+}
+
+bool TryFastForwardQuietBlock(
+    StockState& stockState,
+    std::span<const Snapshot> snapshots,
+    const std::vector<SnapshotBlock>& blocks,
+    int& index
+)
+{
+    if (IsFastForwardDisabled() || index % kSnapshotBlockSize != 0)
+    {
+        return false;
+    }
+
+    const size_t blockIndex = index / kSnapshotBlockSize;
+    if (blockIndex >= blocks.size())
+    {
+        return false;
+    }
+
+    const SnapshotBlock& block = blocks[blockIndex];
+
+    // Snapshots with a wide spread or a missing side are skipped by the reconcile
+    // step, so their quotes must not reach lastAsk/lastBid or the extremes; a
+    // missing last quote makes the first snapshot a change regardless of its value.
+    if (block.maxSpread >= stockState.spaceBetweenIntervals || !block.minAsk ||
+        !block.minBid || !stockState.lastAsk || !stockState.lastBid)
+    {
+        return false;
+    }
+
+    if (!IsInQuietBand(stockState.intervals, block))
+    {
+        return false;
+    }
+
+    const int end = min<int>(index + kSnapshotBlockSize, snapshots.size());
+    const Snapshot& lastSnapshot = snapshots[end - 1];
+
+    if (stockState.position == 0)
+    {
+        // UpdateExitPnL leaves everything but the last quote alone without a position.
+        stockState.lastAsk = lastSnapshot.ask;
+        stockState.lastBid = lastSnapshot.bid;
+        index = end;
+
+        return true;
+    }
+
+    if (!stockState.openPositionTotals.initialized)
+    {
+        InitializeOpenPositionTotals(stockState);
+    }
+
+    const auto& totals = stockState.openPositionTotals;
+
+    // Exit PnL is linear in bid (open longs) and ask (open shorts). With only one side
+    // open it is monotonic in a single quote, so the block extremes give its extremes.
+    if (totals.numWithoutPrice > 0 || (totals.numLongs > 0 && totals.numShorts > 0))
+    {
+        return false;
+    }
+
+    // An execution on an unchanged quote leaves exitPnL stale until the quote changes.
+    // The extremes below assume the stored value is current.
+    if (GetExitPnL(stockState) != stockState.exitPnL)
+    {
+        return false;
+    }
+
+    const FixedPrice highestExitPnL =
+        GetExitPnLAtQuote(stockState, block.maxBid, block.minAsk);
+    const FixedPrice lowestExitPnL =
+        GetExitPnLAtQuote(stockState, block.minBid, block.maxAsk);
+
+    const FixedPrice highestPercentage =
+        GetExitPnLAsPercentage(stockState, highestExitPnL);
+    const FixedPrice lowestPercentage =
+        GetExitPnLAsPercentage(stockState, lowestExitPnL);
+
+    // Which loss is recorded with a newly reached profit threshold depends on the order
+    // of the snapshots, so such blocks are reconciled one snapshot at a time.
+    if (IsUnreachedProfitThresholdAtOrBelow(stockState, highestPercentage))
+    {
+        return false;
+    }
+
+    stockState.lastAsk = lastSnapshot.ask;
+    stockState.lastBid = lastSnapshot.bid;
+
+    stockState.exitPnL = GetExitPnL(stockState);
+    stockState.exitPnLAsPercentage =
+        GetExitPnLAsPercentage(stockState, stockState.exitPnL);
+
+    stockState.maxMovingProfitAsPercentage =
+        max(stockState.maxMovingProfitAsPercentage, highestPercentage);
+    stockState.maxMovingLossAsPercentage =
+        min(stockState.maxMovingLossAsPercentage, lowestPercentage);
+
+    index = end;
+
+    return true;
+}
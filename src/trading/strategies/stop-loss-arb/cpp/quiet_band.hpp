@@ -0,0 +1,28 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "types.hpp"
+
+const int kSnapshotBlockSize = 64;
+
+// NO_FAST_FORWARD: reconcile every historical snapshot, even in quiet blocks.
+bool IsFastForwardDisabled();
+
+std::vector<SnapshotBlock> GetSnapshotBlocks(const std::vector<Snapshot>& snapshots);
+
+// If `index` is at a block boundary and no snapshot in the block can cross or execute
+// an interval, applies the block in one step, moves `index` past it and returns true:
+// the last quote, exit PnL and the moving profit/loss extremes end up exactly as if
+// each snapshot had been reconciled. Returns false, changing nothing, otherwise.
+// `blocks` must come from GetSnapshotBlocks(snapshots).
+bool TryFastForwardQuietBlock(
+    StockState& stockState,
+    std::span<const Snapshot> snapshots,
+    const std::vector<SnapshotBlock>& blocks,
+    int& index
+);
+
+// Same, on the stock's loaded historical snapshots.
+bool TryFastForwardQuietBlock(StockState& stockState);
@@ -0,0 +1,298 @@
+#include "raw_quotes.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <map>
+#include <thread>
+
+#include "numeric_conversions.hpp"
+#include "snapshot_file.hpp"
+#include "timestamp.hpp"
+#include "utils.hpp"
+
+using namespace std;
+
+const int64_t kNanosecondsPerSecond = 1'000'000'000;
+
+SessionWindow GetSessionWindow(const std::string& date)
+{
+    SessionWindow session{};
+
+    if (!TryParseEasternTimestamp(format("{} 09:40:00am ET", date), session.opensAt) ||
+        !TryParseEasternTimestamp(format("{} 03:50:00pm ET", date), session.closesAt))
+    {
+        throw exception(format("Error: Invalid date {}", date).c_str());
+    }
+
+    return session;
+}
+
+// Splits the next field off a CSV row. Quoted fields (Polygon writes the conditions
+// list as "1,2") are returned with their quotes.
+string_view NextCsvField(string_view& row)
+{
+    size_t end = 0;
+    if (!row.empty() && row[0] == '"')
+    {
+        end = row.find('"', 1);
+        end = end == string_view::npos ? row.size() : end + 1;
+    }
+
+    end = row.find(',', end);
+    if (end == string_view::npos)
+    {
+        const string_view field = row;
+        row = {};
+        return field;
+    }
+
+    const string_view field = row.substr(0, end);
+    row.remove_prefix(end + 1);
+    return field;
+}
+
+string_view NextCsvRow(string_view& csv)
+{
+    const size_t end = csv.find('\n');
+    string_view row = csv.substr(0, end);
+    csv.remove_prefix(end == string_view::npos ? csv.size() : end + 1);
+
+    if (!row.empty() && row.back() == '\r')
+    {
+        row.remove_suffix(1);
+    }
+
+    return row;
+}
+
+struct RawQuoteColumns
+{
+    int sipTimestamp = -1;
+    int bidPrice = -1;
+    int askPrice = -1;
+};
+
+RawQuoteColumns GetRawQuoteColumns(string_view header)
+{
+    RawQuoteColumns columns;
+
+    for (int i = 0; !header.empty(); ++i)
+    {
+        const string_view name = NextCsvField(header);
+
+        if (name == "sip_timestamp")
+        {
+            columns.sipTimestamp = i;
+        }
+        else if (name == "bid_price")
+        {
+            columns.bidPrice = i;
+        }
+        else if (name == "ask_price")
+        {
+            columns.askPrice = i;
+        }
+    }
+
+    if (columns.sipTimestamp < 0 || columns.bidPrice < 0 || columns.askPrice < 0)
+    {
+        throw exception(
+            "Error: Quotes header needs sip_timestamp, bid_price and ask_price columns"
+        );
+    }
+
+    return columns;
+}
+
+std::vector<Snapshot> GetSnapshotsByTheSecond(
+    std::string_view csv, const SessionWindow& session
+)
+{
+    const RawQuoteColumns columns = GetRawQuoteColumns(NextCsvRow(csv));
+    const int numColumnsNeeded =
+        max({columns.sipTimestamp, columns.bidPrice, columns.askPrice}) + 1;
+
+    vector<Snapshot> snapshots;
+    snapshots.reserve(session.closesAt - session.opensAt);
+
+    int64_t lastSeconds = INT64_MIN;
+    for (int rowNumber = 2; !csv.empty(); ++rowNumber)
+    {
+        string_view row = NextCsvRow(csv);
+        if (row.empty())
+        {
+            continue;
+        }
+
+        string_view sipTimestamp;
+        string_view bidPrice;
+        string_view askPrice;
+        for (int i = 0; i < numColumnsNeeded; ++i)
+        {
+            const string_view field = NextCsvField(row);
+
+            if (i == columns.sipTimestamp)
+            {
+                sipTimestamp = field;
+            }
+            else if (i == columns.bidPrice)
+            {
+                bidPrice = field;
+            }
+            else if (i == columns.askPrice)
+            {
+                askPrice = field;
+            }
+        }
+
+        int64_t nanoseconds = 0;
+        const auto [end, error] = from_chars(
+            sipTimestamp.data(), sipTimestamp.data() + sipTimestamp.size(), nanoseconds
+        );
+        if (error != errc() || end != sipTimestamp.data() + sipTimestamp.size() ||
+            nanoseconds < 0)
+        {
+            throw exception(format(
+                "Error: Invalid sip_timestamp in quotes row {}", rowNumber
+            ).c_str());
+        }
+
+        const int64_t seconds = nanoseconds / kNanosecondsPerSecond;
+        if (seconds < lastSeconds)
+        {
+            throw exception(format(
+                "Error: Quotes row {} is out of sip_timestamp order", rowNumber
+            ).c_str());
+        }
+
+        if (seconds == lastSeconds || seconds < session.opensAt ||
+            seconds >= session.closesAt)
+        {
+            continue;
+        }
+        lastSeconds = seconds;
+
+        Snapshot snapshot{};
+        if (!TryParseFixedPrice(askPrice, snapshot.ask) ||
+            !TryParseFixedPrice(bidPrice, snapshot.bid))
+        {
+            throw exception(
+                format("Error: Invalid price in quotes row {}", rowNumber).c_str()
+            );
+        }
+        snapshot.timestamp = seconds;
+
+        snapshots.push_back(snapshot);
+    }
+
+    return snapshots;
+}
+
+struct RawQuoteFile
+{
+    filesystem::path rawPath;
+    filesystem::path snapshotPath;
+    const SessionWindow* session;
+};
+
+int ConvertRawQuoteFilesToSnapshots(
+    const std::string& rawRoot, const std::string& snapshotRoot, bool isCompressed
+)
+{
+    // Planned up front: the session window of each date is computed once, and the
+    // output folders are created before the workers start writing into them.
+    map<string, SessionWindow> sessions;
+    vector<RawQuoteFile> files;
+
+    for (const auto& entry : filesystem::recursive_directory_iterator(rawRoot))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".csv")
+        {
+            continue;
+        }
+
+        const string ticker = entry.path().parent_path().filename().string();
+        const string date = entry.path().stem().string();
+
+        auto session = sessions.find(date);
+        if (session == sessions.end())
+        {
+            try
+            {
+                session = sessions.emplace(date, GetSessionWindow(date)).first;
+            }
+            catch (const std::exception& e)
+            {
+                Print(format("Skipped {}: {}", entry.path().string(), e.what()));
+                continue;
+            }
+        }
+
+        const auto folder = filesystem::path(snapshotRoot) / date.substr(0, 4) /
+                            date.substr(5, 2) / date;
+        filesystem::create_directories(folder);
+
+        files.push_back(
+            RawQuoteFile{entry.path(), folder / (ticker + ".bin"), &session->second}
+        );
+    }
+
+    atomic<size_t> nextFile{0};
+    atomic<int> numConverted{0};
+
+    const int numThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+
+    vector<thread> threads;
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+                {
+                    const RawQuoteFile& file = files[i];
+
+                    try
+                    {
+                        const auto mappedFile = MapFile(file.rawPath.string());
+                        const string_view csv(
+                            reinterpret_cast<const char*>(mappedFile->data),
+                            mappedFile->size
+                        );
+
+                        const vector<Snapshot> snapshots =
+                            GetSnapshotsByTheSecond(csv, *file.session);
+
+                        if (isCompressed)
+                        {
+                            WriteCompressedSnapshotFile(
+                                file.snapshotPath.string(), snapshots
+                            );
+                        }
+                        else
+                        {
+                            WriteSnapshotFile(file.snapshotPath.string(), snapshots);
+                        }
+
+                        numConverted++;
+                    }
+                    catch (const std::exception& e)
+                    {
+                        Print(
+                            format("Skipped {}: {}", file.rawPath.string(), e.what())
+                        );
+                    }
+                }
+            }
+        );
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return numConverted;
+}
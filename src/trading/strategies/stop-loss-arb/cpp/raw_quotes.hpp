@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "types.hpp"
+
+// Builds the per-second historical snapshots from raw quote dumps stored locally, as
+// save-stock-historical-data.ts does from the Polygon API, without going through JS
+// or JSON.
+//
+// A dump is a CSV file <raw root>/<TICKER>/<YYYY-MM-DD>.csv with a header row naming
+// at least the sip_timestamp (nanoseconds since the epoch), bid_price and ask_price
+// columns, e.g. a Polygon quotes export; other columns are ignored. Quotes must be in
+// sip_timestamp order.
+
+// The hedging session of a date, [opensAt, closesAt) in epoch seconds.
+struct SessionWindow
+{
+    int64_t opensAt;
+    int64_t closesAt;
+};
+
+// 9:40:00am to 3:50:00pm Eastern (MARKET_OPENS and MARKET_CLOSES in utils/time.ts).
+// Throws if `date` is not a YYYY-MM-DD date.
+SessionWindow GetSessionWindow(const std::string& date);
+
+// The first quote of every second inside the session. Throws if the header lacks a
+// needed column or a row cannot be parsed.
+std::vector<Snapshot> GetSnapshotsByTheSecond(
+    std::string_view csv, const SessionWindow& session
+);
+
+// Converts every dump under `rawRoot` into <snapshot root>/<YYYY>/<MM>/<YYYY-MM-DD>/
+// <TICKER>.bin (compressed if `isCompressed`, see snapshot_file.hpp), on all cores.
+// Dumps that fail are reported and skipped. Returns how many files were written.
+int ConvertRawQuoteFilesToSnapshots(
+    const std::string& rawRoot, const std::string& snapshotRoot, bool isCompressed
+);
@@ -0,0 +1,38 @@
+#include "repeated_quotes.hpp"
+
+#include "price_simulator.hpp"
+
+using namespace std;
+
+bool IsQuoteCollapseDisabled()
+{
+    static const bool isQuoteCollapseDisabled = IsTruthyEnv("NO_QUOTE_COLLAPSE");
+    return isQuoteCollapseDisabled;
+}
+
+void CollapseRepeatedQuotes(std::vector<Snapshot>& snapshots)
+{
+    if (snapshots.empty())
+    {
+        return;
+    }
+
+    size_t last = 0;
+    for (size_t i = 1; i < snapshots.size(); ++i)
+    {
+        Snapshot& run = snapshots[last];
+        const Snapshot& snapshot = snapshots[i];
+
+        if (snapshot.ask == run.ask && snapshot.bid == run.bid &&
+            snapshot.timestamp == run.timestamp + run.repeatCount)
+        {
+            run.repeatCount += snapshot.repeatCount;
+            continue;
+        }
+
+        snapshots[++last] = snapshot;
+    }
+
+    snapshots.resize(last + 1);
+    snapshots.shrink_to_fit();
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+#include "types.hpp"
+
+// NO_QUOTE_COLLAPSE: keep one snapshot per second in loaded historical days.
+bool IsQuoteCollapseDisabled();
+
+// Merges every run of snapshots with the same ask and bid on consecutive seconds into
+// its first snapshot, whose repeatCount becomes the length of the run. The per-second
+// snapshots stay recoverable with GetRepeatedSnapshot.
+void CollapseRepeatedQuotes(std::vector<Snapshot>& snapshots);
+
+// The `repeat`th second of a collapsed snapshot, as a single-second snapshot.
+inline Snapshot GetRepeatedSnapshot(const Snapshot& snapshot, int repeat)
+{
+    return Snapshot{snapshot.ask, snapshot.bid, snapshot.timestamp + repeat, 1};
+}
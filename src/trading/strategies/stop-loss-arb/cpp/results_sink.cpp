@@ -0,0 +1,416 @@
+#include "results_sink.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <thread>
+
+#include "bounded_queue.hpp"
+#include "price_simulator.hpp"
+#include "utils.hpp"
+
+using namespace std;
+
+const size_t kResultsQueueCapacity = 4096;
+const size_t kResultsBatchSize = 256;
+
+const char* const kProfitThresholdNames[4] = {"1", "0_75", "0_5", "0_25"};
+
+enum class ResultsTextFormat
+{
+    NONE,
+    CSV,
+    JSONL
+};
+
+string GetResultsDirectory()
+{
+    const char* directory = getenv("RESULTS_DIR");
+    if (directory != nullptr && *directory != '\0')
+    {
+        return directory;
+    }
+
+    const string cwd = filesystem::current_path().string();
+
+    return format("{}\\..\\deephedge\\results", cwd);
+}
+
+ResultsTextFormat GetResultsTextFormat()
+{
+    const char* textFormat = getenv("RESULTS_TEXT_FORMAT");
+    if (textFormat == nullptr)
+    {
+        return ResultsTextFormat::NONE;
+    }
+
+    const string_view name = textFormat;
+    if (name == "csv")
+    {
+        return ResultsTextFormat::CSV;
+    }
+
+    if (name == "jsonl")
+    {
+        return ResultsTextFormat::JSONL;
+    }
+
+    return ResultsTextFormat::NONE;
+}
+
+uint64_t GetResultsRunId()
+{
+    static const uint64_t runId = []()
+    {
+        const char* runIdStr = getenv("RESULTS_RUN_ID");
+        if (runIdStr != nullptr)
+        {
+            char* end = nullptr;
+            const unsigned long long value = strtoull(runIdStr, &end, 10);
+            if (end != runIdStr && *end == '\0')
+            {
+                return static_cast<uint64_t>(value);
+            }
+        }
+
+        const auto now = chrono::system_clock::now().time_since_epoch();
+        return static_cast<uint64_t>(
+            chrono::duration_cast<chrono::milliseconds>(now).count()
+        );
+    }();
+
+    return runId;
+}
+
+uint64_t GetConfigHash(const StockState& stockState)
+{
+    uint64_t hash = kFnvOffsetBasis;
+
+    HashInteger(hash, stockState.isStaticIntervals);
+    HashInteger(hash, stockState.brokerageTradingCostPerShare.ticks);
+    HashInteger(hash, stockState.sharesPerInterval);
+    HashInteger(hash, stockState.intervalProfit.ticks);
+    HashInteger(hash, stockState.shiftIntervalsFromInitialPrice);
+    HashInteger(hash, stockState.spaceBetweenIntervals.ticks);
+    HashInteger(hash, stockState.numContracts);
+    HashInteger(hash, stockState.targetPosition);
+
+    return hash;
+}
+
+template <size_t kSize>
+void CopyPadded(char (&destination)[kSize], const string& source)
+{
+    memset(destination, 0, kSize);
+    memcpy(destination, source.data(), min(source.size(), kSize - 1));
+}
+
+template <size_t kSize>
+string_view GetPaddedString(const char (&padded)[kSize])
+{
+    return string_view(padded, strnlen(padded, kSize));
+}
+
+ResultRecord GetResultRecord(
+    const std::string& stock, const StockState& stockState, const DayResult& result
+)
+{
+    ResultRecord record{};
+
+    record.runId = GetResultsRunId();
+    record.configHash = GetConfigHash(stockState);
+    CopyPadded(record.ticker, stock);
+    CopyPadded(record.date, stockState.date);
+
+    record.position = result.position;
+    record.numTrades = result.numTrades;
+    record.realizedPnL = result.realizedPnL.ticks;
+    record.exitPnL = result.exitPnL.ticks;
+    record.exitPnLAsPercentage = result.exitPnLAsPercentage.ticks;
+    record.maxMovingProfitAsPercentage = result.maxMovingProfitAsPercentage.ticks;
+    record.maxMovingLossAsPercentage = result.maxMovingLossAsPercentage.ticks;
+
+    record.reachedProfit[0] = result.reached_1_percentage_profit;
+    record.maxLossWhenReachedProfit[0] =
+        result.max_loss_when_reached_1_percentage_profit.ticks;
+
+    record.reachedProfit[1] = result.reached_0_75_percentage_profit;
+    record.maxLossWhenReachedProfit[1] =
+        result.max_loss_when_reached_0_75_percentage_profit.ticks;
+
+    record.reachedProfit[2] = result.reached_0_5_percentage_profit;
+    record.maxLossWhenReachedProfit[2] =
+        result.max_loss_when_reached_0_5_percentage_profit.ticks;
+
+    record.reachedProfit[3] = result.reached_0_25_percentage_profit;
+    record.maxLossWhenReachedProfit[3] =
+        result.max_loss_when_reached_0_25_percentage_profit.ticks;
+
+    return record;
+}
+
+string GetCsvHeader()
+{
+    string header = "run_id,config_hash,ticker,date,position,num_trades,realized_pnl,"
+                    "exit_pnl,exit_pnl_as_percentage,max_moving_profit_as_percentage,"
+                    "max_moving_loss_as_percentage";
+
+    for (const char* name : kProfitThresholdNames)
+    {
+        header += format(
+            ",reached_{0}_percentage_profit"
+            ",max_loss_when_reached_{0}_percentage_profit",
+            name
+        );
+    }
+
+    return header + "\n";
+}
+
+void AppendCsvRow(string& text, const ResultRecord& record)
+{
+    text += format(
+        "{},{:016x},{},{},{},{},{},{},{},{},{}",
+        record.runId,
+        record.configHash,
+        GetPaddedString(record.ticker),
+        GetPaddedString(record.date),
+        record.position,
+        record.numTrades,
+        FixedPrice::FromTicks(record.realizedPnL).str(),
+        FixedPrice::FromTicks(record.exitPnL).str(),
+        FixedPrice::FromTicks(record.exitPnLAsPercentage).str(),
+        FixedPrice::FromTicks(record.maxMovingProfitAsPercentage).str(),
+        FixedPrice::FromTicks(record.maxMovingLossAsPercentage).str()
+    );
+
+    for (int i = 0; i < 4; ++i)
+    {
+        text += format(
+            ",{},{}",
+            record.reachedProfit[i] ? "true" : "false",
+            FixedPrice::FromTicks(record.maxLossWhenReachedProfit[i]).str()
+        );
+    }
+
+    text += "\n";
+}
+
+void AppendJsonLine(string& text, const ResultRecord& record)
+{
+    text += format(
+        "{{\"run_id\":{},\"config_hash\":\"{:016x}\",\"ticker\":\"{}\",\"date\":\"{}\","
+        "\"position\":{},\"num_trades\":{},\"realized_pnl\":{},\"exit_pnl\":{},"
+        "\"exit_pnl_as_percentage\":{},\"max_moving_profit_as_percentage\":{},"
+        "\"max_moving_loss_as_percentage\":{}",
+        record.runId,
+        record.configHash,
+        GetPaddedString(record.ticker),
+        GetPaddedString(record.date),
+        record.position,
+        record.numTrades,
+        FixedPrice::FromTicks(record.realizedPnL).str(),
+        FixedPrice::FromTicks(record.exitPnL).str(),
+        FixedPrice::FromTicks(record.exitPnLAsPercentage).str(),
+        FixedPrice::FromTicks(record.maxMovingProfitAsPercentage).str(),
+        FixedPrice::FromTicks(record.maxMovingLossAsPercentage).str()
+    );
+
+    for (int i = 0; i < 4; ++i)
+    {
+        text += format(
+            ",\"reached_{0}_percentage_profit\":{1},"
+            "\"max_loss_when_reached_{0}_percentage_profit\":{2}",
+            kProfitThresholdNames[i],
+            record.reachedProfit[i] ? "true" : "false",
+            FixedPrice::FromTicks(record.maxLossWhenReachedProfit[i]).str()
+        );
+    }
+
+    text += "}\n";
+}
+
+// Opens `path` for appending; `header` is written first if the file is new or empty.
+ofstream OpenAppendFile(const filesystem::path& path, string_view header)
+{
+    const bool isNew = !filesystem::exists(path) || filesystem::file_size(path) == 0;
+
+    ofstream out(path, ios::binary | ios::app);
+    if (!out.is_open())
+    {
+        throw exception(format("Error: Unable to open file {}", path.string()).c_str());
+    }
+
+    if (isNew)
+    {
+        out.write(header.data(), header.size());
+    }
+
+    return out;
+}
+
+void CheckResultsFileHeader(const filesystem::path& path)
+{
+    if (!filesystem::exists(path) || filesystem::file_size(path) == 0)
+    {
+        return;
+    }
+
+    ResultsFileHeader header{};
+    ifstream file(path, ios::binary);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!file || memcmp(header.magic, kResultsFileMagic, sizeof(header.magic)) != 0 ||
+        header.version != kResultsFileVersion ||
+        header.recordSize != sizeof(ResultRecord) ||
+        header.tickDecimals != kFixedPriceDecimals)
+    {
+        throw exception(format(
+            "Error: {} is not a version {} results file with {} tick decimals",
+            path.string(),
+            kResultsFileVersion,
+            kFixedPriceDecimals
+        ).c_str());
+    }
+}
+
+// Owns the results files. Appending is a copy into the queue; the one writer thread
+// drains it in batches, with one write per file per batch.
+struct ResultsSink
+{
+    BoundedQueue<ResultRecord> records{kResultsQueueCapacity};
+    ofstream binaryFile;
+    ofstream textFile;
+    ResultsTextFormat textFormat = ResultsTextFormat::NONE;
+
+    mutex lock;
+    condition_variable written;
+    uint64_t numAppended = 0;
+    uint64_t numWritten = 0;
+
+    thread writer;
+
+    ResultsSink()
+    {
+        const filesystem::path directory = GetResultsDirectory();
+        filesystem::create_directories(directory);
+
+        ResultsFileHeader header{};
+        memcpy(header.magic, kResultsFileMagic, sizeof(header.magic));
+        header.version = kResultsFileVersion;
+        header.recordSize = sizeof(ResultRecord);
+        header.tickDecimals = kFixedPriceDecimals;
+
+        const auto binaryPath = directory / "results.bin";
+        CheckResultsFileHeader(binaryPath);
+        binaryFile = OpenAppendFile(
+            binaryPath,
+            string_view(reinterpret_cast<const char*>(&header), sizeof(header))
+        );
+
+        textFormat = GetResultsTextFormat();
+        if (textFormat == ResultsTextFormat::CSV)
+        {
+            textFile = OpenAppendFile(directory / "results.csv", GetCsvHeader());
+        }
+        else if (textFormat == ResultsTextFormat::JSONL)
+        {
+            textFile = OpenAppendFile(directory / "results.jsonl", "");
+        }
+
+        writer = thread([this]() { WriteRecords(); });
+    }
+
+    ~ResultsSink()
+    {
+        records.Close();
+        writer.join();
+    }
+
+    void Append(const ResultRecord& record)
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            numAppended++;
+        }
+
+        records.Push(record);
+    }
+
+    void Flush()
+    {
+        unique_lock<mutex> guard(lock);
+        const uint64_t target = numAppended;
+        written.wait(guard, [&]() { return numWritten >= target; });
+    }
+
+    void WriteRecords()
+    {
+        string text;
+
+        for (auto batch = records.PopBatch(kResultsBatchSize); !batch.empty();
+             batch = records.PopBatch(kResultsBatchSize))
+        {
+            binaryFile.write(
+                reinterpret_cast<const char*>(batch.data()),
+                batch.size() * sizeof(ResultRecord)
+            );
+
+            if (textFormat != ResultsTextFormat::NONE)
+            {
+                text.clear();
+                for (const auto& record : batch)
+                {
+                    if (textFormat == ResultsTextFormat::CSV)
+                    {
+                        AppendCsvRow(text, record);
+                    }
+                    else
+                    {
+                        AppendJsonLine(text, record);
+                    }
+                }
+
+                textFile.write(text.data(), text.size());
+                textFile.flush();
+            }
+
+            binaryFile.flush();
+            if (!binaryFile || (textFormat != ResultsTextFormat::NONE && !textFile))
+            {
+                Print(format(
+                    "Error: Unable to write {} results to {}",
+                    batch.size(),
+                    GetResultsDirectory()
+                ));
+            }
+
+            {
+                lock_guard<mutex> guard(lock);
+                numWritten += batch.size();
+            }
+            written.notify_all();
+        }
+    }
+};
+
+ResultsSink& GetResultsSink()
+{
+    static ResultsSink sink;
+    return sink;
+}
+
+void AppendDayResult(
+    const std::string& stock, const StockState& stockState, const DayResult& result
+)
+{
+    GetResultsSink().Append(GetResultRecord(stock, stockState, result));
+}
+
+void FlushResults()
+{
+    GetResultsSink().Flush();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "types.hpp"
+
+// Backtest results are appended to <results dir>/results.bin, one ResultRecord per
+// simulated (ticker, date), instead of being written back into the snapshot files.
+// The results dir is RESULTS_DIR, by default cwd\..\deephedge\results.
+// RESULTS_TEXT_FORMAT=csv or jsonl also appends each record to results.csv or
+// results.jsonl.
+//
+// results.bin starts with a ResultsFileHeader; records follow back to back in host
+// (little-endian) byte order. Prices and percentages are FixedPrice ticks.
+
+const char kResultsFileMagic[8] = {'D', 'H', 'R', 'E', 'S', 'U', 'L', 'T'};
+const uint32_t kResultsFileVersion = 1;
+
+struct ResultsFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t tickDecimals;
+    uint32_t reserved;
+};
+
+struct ResultRecord
+{
+    uint64_t runId;
+    uint64_t configHash;
+    char ticker[16];  // NUL padded
+    char date[16];    // YYYY-MM-DD, NUL padded
+    int64_t position;
+    int64_t numTrades;
+    int64_t realizedPnL;
+    int64_t exitPnL;
+    int64_t exitPnLAsPercentage;
+    int64_t maxMovingProfitAsPercentage;
+    int64_t maxMovingLossAsPercentage;
+    // Indexed like kProfitThresholdNames: 1%, 0.75%, 0.5% and 0.25% profit.
+    int64_t maxLossWhenReachedProfit[4];
+    uint8_t reachedProfit[4];
+    uint8_t padding[4];
+};
+
+// RESULTS_RUN_ID if set, else the time the process first recorded a result, in
+// milliseconds since the epoch.
+uint64_t GetResultsRunId();
+
+// Hash of the strategy settings of a stock state (sizes, spacing, profit, costs), so
+// results of runs with different settings can be told apart. Day-specific values
+// such as the initial price are left out.
+uint64_t GetConfigHash(const StockState& stockState);
+
+ResultRecord GetResultRecord(
+    const std::string& stock, const StockState& stockState, const DayResult& result
+);
+
+// Queues the record for the writer thread and returns; blocks only while the writer
+// is far behind. Thread-safe.
+void AppendDayResult(
+    const std::string& stock, const StockState& stockState, const DayResult& result
+);
+
+// Blocks until every result appended so far is written out.
+void FlushResults();
@@ -0,0 +1,105 @@
+#include "simulate_day.hpp"
+
+#include "algo.hpp"
+#include "quiet_band.hpp"
+#include "repeated_quotes.hpp"
+
+using namespace std;
+
+template <bool kIsStaticIntervals, int kNumWords>
+void SimulateDayFor(
+    const std::string& stock,
+    StockState& stockState,
+    std::span<const Snapshot> snapshots,
+    const std::vector<SnapshotBlock>* blocks
+)
+{
+    const int numSnapshots = static_cast<int>(snapshots.size());
+
+    int index = 0;
+    while (index < numSnapshots)
+    {
+        if (blocks != nullptr &&
+            TryFastForwardQuietBlock(stockState, snapshots, *blocks, index))
+        {
+            continue;
+        }
+
+        const Snapshot& snapshot = snapshots[index];
+
+        size_t numTradingLogs = stockState.tradingLogs.size();
+        ReconcileStockPositionOnSnapshotFor<kIsStaticIntervals, kNumWords>(
+            stock, stockState, snapshot
+        );
+
+        // Once a second of the quote passes without a trade, the rest of its seconds
+        // would too: its crossings are marked and nothing else changes while it holds.
+        for (int repeat = 1; repeat < snapshot.repeatCount &&
+                             stockState.tradingLogs.size() != numTradingLogs;
+             ++repeat)
+        {
+            numTradingLogs = stockState.tradingLogs.size();
+            ReconcileStockPositionOnSnapshotFor<kIsStaticIntervals, kNumWords>(
+                stock, stockState, GetRepeatedSnapshot(snapshot, repeat)
+            );
+        }
+
+        index++;
+    }
+}
+
+DayResult SimulateDay(
+    const std::string& stock,
+    StockState& stockState,
+    std::span<const Snapshot> snapshots,
+    const std::vector<SnapshotBlock>* blocks
+)
+{
+    const size_t numTradingLogs = stockState.tradingLogs.size();
+
+    DispatchOnIntervalKernel(
+        stockState,
+        [&]<bool kIsStaticIntervals, int kNumWords>()
+        {
+            SimulateDayFor<kIsStaticIntervals, kNumWords>(
+                stock, stockState, snapshots, blocks
+            );
+        }
+    );
+
+    const int numTrades =
+        static_cast<int>(stockState.tradingLogs.size() - numTradingLogs);
+
+    return GetDayResult(stockState, numTrades);
+}
+
+DayResult GetDayResult(const StockState& stockState, int numTrades)
+{
+    DayResult result{};
+
+    result.position = stockState.position;
+    result.numTrades = numTrades;
+    result.realizedPnL = stockState.realizedPnL;
+    result.exitPnL = stockState.exitPnL;
+    result.exitPnLAsPercentage = stockState.exitPnLAsPercentage;
+    result.maxMovingProfitAsPercentage = stockState.maxMovingProfitAsPercentage;
+    result.maxMovingLossAsPercentage = stockState.maxMovingLossAsPercentage;
+
+    result.reached_1_percentage_profit = stockState.reached_1_percentage_profit;
+    result.max_loss_when_reached_1_percentage_profit =
+        stockState.max_loss_when_reached_1_percentage_profit;
+
+    result.reached_0_75_percentage_profit = stockState.reached_0_75_percentage_profit;
+    result.max_loss_when_reached_0_75_percentage_profit =
+        stockState.max_loss_when_reached_0_75_percentage_profit;
+
+    result.reached_0_5_percentage_profit = stockState.reached_0_5_percentage_profit;
+    result.max_loss_when_reached_0_5_percentage_profit =
+        stockState.max_loss_when_reached_0_5_percentage_profit;
+
+    result.reached_0_25_percentage_profit = stockState.reached_0_25_percentage_profit;
+    result.max_loss_when_reached_0_25_percentage_profit =
+        stockState.max_loss_when_reached_0_25_percentage_profit;
+
+    return result;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+// Runs a whole day of snapshots through the reconcile step in one loop, with the
+// kernel for the stock's interval mode and ladder size picked once up front. The
+// snapshots are read in place and `stockState` (ladder, position, PnL) is updated as
+// ReconcileStockPositionOnSnapshot would for each of them, and for each second of
+// a collapsed snapshot (repeatCount > 1). `blocks`, from GetSnapshotBlocks(snapshots),
+// enables quiet-band fast-forwarding; may be null.
+DayResult SimulateDay(
+    const std::string& stock,
+    StockState& stockState,
+    std::span<const Snapshot> snapshots,
+    const std::vector<SnapshotBlock>* blocks
+);
+
+DayResult GetDayResult(const StockState& stockState, int numTrades);
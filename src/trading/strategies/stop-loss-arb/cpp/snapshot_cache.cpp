@@ -0,0 +1,168 @@
+#include "snapshot_cache.hpp"
+
+#include <cstdlib>
+#include <format>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "price_simulator.hpp"
+#include "quiet_band.hpp"
+#include "repeated_quotes.hpp"
+
+using namespace std;
+
+const size_t kDefaultSnapshotCacheMegabytes = 512;
+
+struct SnapshotCacheEntry
+{
+    shared_future<shared_ptr<const SnapshotDataset>> dataset;
+    size_t numBytes = 0;  // 0 while loading
+    list<string>::iterator recentlyUsed;
+};
+
+struct SnapshotCache
+{
+    mutex lock;
+    unordered_map<string, SnapshotCacheEntry> entries;
+    list<string> recentlyUsed;  // most recently used first
+    size_t numBytes = 0;
+};
+
+SnapshotCache& GetSnapshotCache()
+{
+    static SnapshotCache cache;
+    return cache;
+}
+
+size_t GetSnapshotCacheBudget()
+{
+    static const size_t budget = []()
+    {
+        const char* megabytesStr = getenv("SNAPSHOT_CACHE_MEGABYTES");
+
+        size_t megabytes = kDefaultSnapshotCacheMegabytes;
+        if (megabytesStr != nullptr)
+        {
+            char* end = nullptr;
+            const unsigned long long value = strtoull(megabytesStr, &end, 10);
+            if (end != megabytesStr && *end == '\0')
+            {
+                megabytes = static_cast<size_t>(value);
+            }
+        }
+
+        return megabytes * 1024 * 1024;
+    }();
+
+    return budget;
+}
+
+size_t GetNumBytes(const SnapshotDataset& dataset)
+{
+    return sizeof(dataset) + dataset.snapshots.capacity() * sizeof(Snapshot) +
+           dataset.blocks.capacity() * sizeof(SnapshotBlock);
+}
+
+// Drops least recently used datasets, skipping ones still loading or held by a
+// simulation (dropping those would free nothing), until the cache is within budget.
+void EvictOverBudget(SnapshotCache& cache)
+{
+    const size_t budget = GetSnapshotCacheBudget();
+
+    auto it = cache.recentlyUsed.end();
+    while (cache.numBytes > budget && it != cache.recentlyUsed.begin())
+    {
+        --it;
+
+        const auto entry = cache.entries.find(*it);
+        const auto& dataset = entry->second.dataset;
+        if (entry->second.numBytes == 0 || dataset.get().use_count() > 1)
+        {
+            continue;
+        }
+
+        cache.numBytes -= entry->second.numBytes;
+        cache.entries.erase(entry);
+        it = cache.recentlyUsed.erase(it);
+    }
+}
+
+shared_ptr<const SnapshotDataset> LoadSnapshotDataset(const StockState& stock_state)
+{
+    auto dataset = make_shared<SnapshotDataset>();
+
+    dataset->snapshots = GetSnapshotsForStockOnDate(stock_state);
+    if (!IsQuoteCollapseDisabled())
+    {
+        CollapseRepeatedQuotes(dataset->snapshots);
+    }
+    dataset->blocks = GetSnapshotBlocks(dataset->snapshots);
+
+    return dataset;
+}
+
+std::shared_ptr<const SnapshotDataset> GetSnapshotDataset(
+    const StockState& stock_state
+)
+{
+    auto& cache = GetSnapshotCache();
+    const string key = format("{}/{}", stock_state.date, stock_state.brokerageId);
+
+    unique_lock<mutex> guard(cache.lock);
+
+    const auto entry = cache.entries.find(key);
+    if (entry != cache.entries.end())
+    {
+        auto& recentlyUsed = cache.recentlyUsed;
+        recentlyUsed.splice(
+            recentlyUsed.begin(), recentlyUsed, entry->second.recentlyUsed
+        );
+
+        // Waits outside the lock if the day is still loading.
+        const auto dataset = entry->second.dataset;
+        guard.unlock();
+
+        return dataset.get();
+    }
+
+    promise<shared_ptr<const SnapshotDataset>> loaded;
+    cache.recentlyUsed.push_front(key);
+    cache.entries.emplace(
+        key,
+        SnapshotCacheEntry{
+            loaded.get_future().share(), 0, cache.recentlyUsed.begin()
+        }
+    );
+    guard.unlock();
+
+    shared_ptr<const SnapshotDataset> dataset;
+    try
+    {
+        dataset = LoadSnapshotDataset(stock_state);
+    }
+    catch (...)
+    {
+        // Waiting requests get the same error; the next request retries the load.
+        loaded.set_exception(current_exception());
+
+        guard.lock();
+        const auto failed = cache.entries.find(key);
+        cache.recentlyUsed.erase(failed->second.recentlyUsed);
+        cache.entries.erase(failed);
+
+        throw;
+    }
+
+    loaded.set_value(dataset);
+
+    guard.lock();
+    const size_t numBytes = GetNumBytes(*dataset);
+    cache.entries.at(key).numBytes = numBytes;
+    cache.numBytes += numBytes;
+    EvictOverBudget(cache);
+
+    return dataset;
+}
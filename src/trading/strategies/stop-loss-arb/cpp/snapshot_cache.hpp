@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "types.hpp"
+
+// Snapshots of one (ticker, date) with their quiet-band blocks. Immutable once loaded,
+// so every simulation of that day shares the same copy.
+struct SnapshotDataset
+{
+    std::vector<Snapshot> snapshots;
+    std::vector<SnapshotBlock> blocks;
+};
+
+// SNAPSHOT_CACHE_MEGABYTES: how much loaded snapshot data the process keeps around
+// for reuse once no simulation holds it. Defaults to 512.
+size_t GetSnapshotCacheBudget();
+
+// Returns the dataset for the stock's ticker and date, loading it on first use.
+// Thread-safe: concurrent requests for a day that is still loading wait for that one
+// load. Least recently used datasets are dropped from the cache when it goes over
+// budget; a dropped dataset stays alive for as long as a simulation holds it.
+std::shared_ptr<const SnapshotDataset> GetSnapshotDataset(
+    const StockState& stock_state
+);
@@ -0,0 +1,171 @@
+#include "snapshot_codec.hpp"
+
+#include <format>
+#include <numeric>
+
+using namespace std;
+
+// Longest varint of a 64-bit value.
+const int kMaxVarintSize = 10;
+
+uint64_t ZigZagEncode(uint64_t delta)
+{
+    return (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+}
+
+uint64_t ZigZagDecode(uint64_t value)
+{
+    return (value >> 1) ^ (0 - (value & 1));
+}
+
+void WriteVarint(uint64_t value, vector<uint8_t>& out)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Reads a varint at `p` without bounds checks; the caller guarantees kMaxVarintSize
+// readable bytes. Returns nullptr if the varint is longer than that.
+const uint8_t* ReadVarintUnchecked(const uint8_t* p, uint64_t& value)
+{
+    // One byte covers unchanged quotes and small moves, which are most of a day.
+    if (*p < 0x80)
+    {
+        value = *p;
+        return p + 1;
+    }
+
+    value = 0;
+    for (int shift = 0; shift < kMaxVarintSize * 7; shift += 7)
+    {
+        const uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+        if (byte < 0x80)
+        {
+            return p;
+        }
+    }
+
+    return nullptr;
+}
+
+const uint8_t* ReadVarint(const uint8_t* p, const uint8_t* end, uint64_t& value)
+{
+    if (end - p >= kMaxVarintSize)
+    {
+        return ReadVarintUnchecked(p, value);
+    }
+
+    value = 0;
+    for (int shift = 0; p < end && shift < kMaxVarintSize * 7; shift += 7)
+    {
+        const uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+        if (byte < 0x80)
+        {
+            return p;
+        }
+    }
+
+    return nullptr;
+}
+
+int64_t GetPriceQuantum(std::span<const Snapshot> snapshots)
+{
+    int64_t quantum = 0;
+
+    for (const auto& snapshot : snapshots)
+    {
+        quantum = gcd(quantum, snapshot.ask.ticks);
+        quantum = gcd(quantum, snapshot.bid.ticks);
+
+        if (quantum == 1)
+        {
+            break;
+        }
+    }
+
+    return quantum == 0 ? 1 : quantum;
+}
+
+void EncodeSnapshotBlock(
+    std::span<const Snapshot> snapshots, int64_t priceQuantum, std::vector<uint8_t>& out
+)
+{
+    // Deltas are taken in uint64 so they wrap instead of overflowing; the decoder
+    // wraps back the same way.
+    uint64_t previousAsk = 0;
+    uint64_t previousSpread = 0;
+    uint64_t previousTimestamp = 0;
+
+    for (const auto& snapshot : snapshots)
+    {
+        const uint64_t ask = snapshot.ask.ticks / priceQuantum;
+        const uint64_t spread = ask - snapshot.bid.ticks / priceQuantum;
+        const uint64_t timestamp = snapshot.timestamp;
+
+        WriteVarint(ZigZagEncode(ask - previousAsk), out);
+        WriteVarint(ZigZagEncode(spread - previousSpread), out);
+        WriteVarint(ZigZagEncode(timestamp - previousTimestamp), out);
+
+        previousAsk = ask;
+        previousSpread = spread;
+        previousTimestamp = timestamp;
+    }
+}
+
+void DecodeSnapshotBlock(
+    std::span<const uint8_t> data, int64_t priceQuantum, std::span<Snapshot> out
+)
+{
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+
+    uint64_t ask = 0;
+    uint64_t spread = 0;
+    uint64_t timestamp = 0;
+
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+        uint64_t askDelta;
+        uint64_t spreadDelta;
+        uint64_t timestampDelta;
+
+        // Away from the end of the block the three varints are read unchecked.
+        if (end - p >= 3 * kMaxVarintSize)
+        {
+            p = ReadVarintUnchecked(p, askDelta);
+            p = p == nullptr ? nullptr : ReadVarintUnchecked(p, spreadDelta);
+            p = p == nullptr ? nullptr : ReadVarintUnchecked(p, timestampDelta);
+        }
+        else
+        {
+            p = ReadVarint(p, end, askDelta);
+            p = p == nullptr ? nullptr : ReadVarint(p, end, spreadDelta);
+            p = p == nullptr ? nullptr : ReadVarint(p, end, timestampDelta);
+        }
+
+        if (p == nullptr)
+        {
+            throw exception(format(
+                "Error: Corrupt snapshot block at snapshot {} of {}", i, out.size()
+            ).c_str());
+        }
+
+        ask += ZigZagDecode(askDelta);
+        spread += ZigZagDecode(spreadDelta);
+        timestamp += ZigZagDecode(timestampDelta);
+
+        Snapshot& snapshot = out[i];
+        snapshot.ask = FixedPrice::FromTicks(static_cast<int64_t>(ask) * priceQuantum);
+        snapshot.bid =
+            FixedPrice::FromTicks(static_cast<int64_t>(ask - spread) * priceQuantum);
+        snapshot.timestamp = static_cast<int64_t>(timestamp);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "types.hpp"
+
+// Compact coding of a day's snapshots for the compressed snapshot file. Snapshots are
+// coded in blocks of kSnapshotCodecBlockSize that decode independently of each other.
+// Within a block each snapshot is three zig-zag varints: the change in ask, in spread
+// (ask - bid) and in timestamp from the previous snapshot (from 0 for the first one).
+// Prices are counted in units of a price quantum, the GCD of all ask and bid ticks, so
+// a one cent move on a cent-priced ticker is a one byte delta.
+
+const int kSnapshotCodecBlockSize = 1024;
+
+// Largest price unit that divides every ask and bid; 1 if all of them are 0.
+int64_t GetPriceQuantum(std::span<const Snapshot> snapshots);
+
+// Appends the coded block to `out`. Every ask and bid must be a multiple of
+// `priceQuantum`.
+void EncodeSnapshotBlock(
+    std::span<const Snapshot> snapshots, int64_t priceQuantum, std::vector<uint8_t>& out
+);
+
+// Decodes exactly out.size() snapshots from `data`. Throws if `data` is too short or
+// not a coded block.
+void DecodeSnapshotBlock(
+    std::span<const uint8_t> data, int64_t priceQuantum, std::span<Snapshot> out
+);
@@ -0,0 +1,482 @@
+#include "snapshot_file.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "price_simulator.hpp"
+#include "snapshot_codec.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const uint64_t kColumnAlignment = 64;
+
+#ifdef _WIN32
+
+MappedFile::~MappedFile()
+{
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+
+    if (mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+    }
+
+    if (fileHandle != nullptr)
+    {
+        CloseHandle(fileHandle);
+    }
+}
+
+std::unique_ptr<MappedFile> MapFile(const std::string& path)
+{
+    auto mappedFile = make_unique<MappedFile>();
+
+    HANDLE file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw exception(format("Error: Unable to open file {}", path).c_str());
+    }
+    mappedFile->fileHandle = file;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        throw exception(format("Error: Unable to map empty file {}", path).c_str());
+    }
+    mappedFile->size = static_cast<size_t>(size.QuadPart);
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        throw exception(format("Error: Unable to map file {}", path).c_str());
+    }
+    mappedFile->mappingHandle = mapping;
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        throw exception(format("Error: Unable to map file {}", path).c_str());
+    }
+    mappedFile->data = static_cast<const std::byte*>(view);
+
+    return mappedFile;
+}
+
+#else
+
+MappedFile::~MappedFile()
+{
+    if (data != nullptr)
+    {
+        munmap(const_cast<std::byte*>(data), size);
+    }
+}
+
+std::unique_ptr<MappedFile> MapFile(const std::string& path)
+{
+    auto mappedFile = make_unique<MappedFile>();
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw exception(format("Error: Unable to open file {}", path).c_str());
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(fd);
+        throw exception(format("Error: Unable to map empty file {}", path).c_str());
+    }
+
+    const size_t size = static_cast<size_t>(fileStat.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (view == MAP_FAILED)
+    {
+        throw exception(format("Error: Unable to map file {}", path).c_str());
+    }
+
+    mappedFile->data = static_cast<const std::byte*>(view);
+    mappedFile->size = size;
+
+    return mappedFile;
+}
+
+#endif
+
+span<const int64_t> GetColumn(
+    const MappedFile& file, uint64_t offset, uint64_t numValues, const string& path
+)
+{
+    if (offset % alignof(int64_t) != 0 || offset > file.size ||
+        numValues > (file.size - offset) / sizeof(int64_t))
+    {
+        throw exception(format("Error: Truncated snapshot file {}", path).c_str());
+    }
+
+    const auto* values = reinterpret_cast<const int64_t*>(file.data + offset);
+    return span<const int64_t>(values, numValues);
+}
+
+uint32_t GetSnapshotFileVersion(const MappedFile& file, const std::string& path)
+{
+    char magic[sizeof(kSnapshotFileMagic)];
+    uint32_t version;
+    if (file.size < sizeof(magic) + sizeof(version))
+    {
+        throw exception(format("Error: Truncated snapshot file {}", path).c_str());
+    }
+    memcpy(magic, file.data, sizeof(magic));
+    memcpy(&version, file.data + sizeof(magic), sizeof(version));
+
+    if (memcmp(magic, kSnapshotFileMagic, sizeof(magic)) != 0)
+    {
+        throw exception(format("Error: {} is not a snapshot file", path).c_str());
+    }
+
+    return version;
+}
+
+// Reads the header and checks the version and tick precision.
+template <typename Header>
+Header ReadSnapshotFileHeader(
+    const MappedFile& file, const string& path, uint32_t expectedVersion
+)
+{
+    const uint32_t version = GetSnapshotFileVersion(file, path);
+    if (version != expectedVersion)
+    {
+        throw exception(format(
+            "Error: Snapshot file {} has version {}, expected {}",
+            path,
+            version,
+            expectedVersion
+        ).c_str());
+    }
+
+    Header header{};
+    if (file.size < sizeof(header))
+    {
+        throw exception(format("Error: Truncated snapshot file {}", path).c_str());
+    }
+    memcpy(&header, file.data, sizeof(header));
+
+    if (header.tickDecimals != kFixedPriceDecimals)
+    {
+        throw exception(format(
+            "Error: Snapshot file {} has {} tick decimals, expected {}",
+            path,
+            header.tickDecimals,
+            kFixedPriceDecimals
+        ).c_str());
+    }
+
+    return header;
+}
+
+MappedSnapshotFile MapSnapshotFile(const std::string& path)
+{
+    return MapSnapshotFile(MapFile(path), path);
+}
+
+MappedSnapshotFile MapSnapshotFile(
+    std::unique_ptr<MappedFile> mappedFile, const std::string& path
+)
+{
+    MappedSnapshotFile result{std::move(mappedFile), {}};
+    const MappedFile& file = *result.file;
+
+    const auto header =
+        ReadSnapshotFileHeader<SnapshotFileHeader>(file, path, kSnapshotFileVersion);
+
+    result.columns.asks = GetColumn(file, header.askOffset, header.numSnapshots, path);
+    result.columns.bids = GetColumn(file, header.bidOffset, header.numSnapshots, path);
+    result.columns.timestamps =
+        GetColumn(file, header.timestampOffset, header.numSnapshots, path);
+
+    return result;
+}
+
+MappedCompressedSnapshotFile MapCompressedSnapshotFile(
+    std::unique_ptr<MappedFile> mappedFile, const std::string& path
+)
+{
+    MappedCompressedSnapshotFile result{std::move(mappedFile), {}, {}};
+    const MappedFile& file = *result.file;
+
+    const auto header = ReadSnapshotFileHeader<CompressedSnapshotFileHeader>(
+        file, path, kCompressedSnapshotFileVersion
+    );
+
+    const uint64_t offset = header.blockOffsetsOffset;
+    if (header.priceQuantum <= 0 || header.blockSize == 0 ||
+        header.numBlocks != (header.numSnapshots + header.blockSize - 1) /
+                                header.blockSize ||
+        offset % alignof(uint64_t) != 0 || offset > file.size ||
+        header.numBlocks >= (file.size - offset) / sizeof(uint64_t))
+    {
+        throw exception(format("Error: Corrupt snapshot file {}", path).c_str());
+    }
+
+    const auto* blockOffsets = reinterpret_cast<const uint64_t*>(file.data + offset);
+    result.blockOffsets = span<const uint64_t>(blockOffsets, header.numBlocks + 1);
+
+    for (size_t i = 0; i < header.numBlocks; ++i)
+    {
+        if (blockOffsets[i] > blockOffsets[i + 1] ||
+            blockOffsets[i + 1] > file.size)
+        {
+            throw exception(format("Error: Corrupt snapshot file {}", path).c_str());
+        }
+    }
+
+    result.header = header;
+
+    return result;
+}
+
+void DecodeSnapshotFileBlock(
+    const MappedCompressedSnapshotFile& file,
+    size_t blockIndex,
+    std::span<Snapshot> out
+)
+{
+    const uint64_t begin = file.blockOffsets[blockIndex];
+    const uint64_t end = file.blockOffsets[blockIndex + 1];
+
+    const auto* data = reinterpret_cast<const uint8_t*>(file.file->data);
+
+    DecodeSnapshotBlock(
+        span<const uint8_t>(data + begin, end - begin), file.header.priceQuantum, out
+    );
+}
+
+void DecodeSnapshotFile(
+    const MappedCompressedSnapshotFile& file, std::vector<Snapshot>& snapshots
+)
+{
+    const size_t numSnapshots = file.header.numSnapshots;
+    const size_t blockSize = file.header.blockSize;
+
+    snapshots.resize(numSnapshots);
+
+    for (size_t i = 0; i < file.header.numBlocks; ++i)
+    {
+        const size_t begin = i * blockSize;
+        const size_t count = min(blockSize, numSnapshots - begin);
+
+        DecodeSnapshotFileBlock(file, i, span(snapshots).subspan(begin, count));
+    }
+}
+
+uint64_t AlignColumnOffset(uint64_t offset)
+{
+    return (offset + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+}
+
+// Writes to a temporary file and renames it over `path`, so a reader never maps a
+// partial file.
+template <typename WriteFunction>
+void WriteFileAtomically(const string& path, WriteFunction write)
+{
+    const string temporaryPath = path + ".tmp";
+    {
+        ofstream out(temporaryPath, ios::binary | ios::trunc);
+        if (!out.is_open())
+        {
+            throw exception(
+                format("Error: Unable to open file {}", temporaryPath).c_str()
+            );
+        }
+
+        write(out);
+
+        if (!out)
+        {
+            throw exception(
+                format("Error: Unable to write file {}", temporaryPath).c_str()
+            );
+        }
+    }
+
+    filesystem::rename(temporaryPath, path);
+}
+
+void WriteColumn(ofstream& out, uint64_t offset, const vector<int64_t>& values)
+{
+    const uint64_t position = static_cast<uint64_t>(out.tellp());
+    const vector<char> padding(offset - position, '\0');
+    out.write(padding.data(), padding.size());
+
+    out.write(
+        reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int64_t)
+    );
+}
+
+void WriteSnapshotFile(const std::string& path, const std::vector<Snapshot>& snapshots)
+{
+    const uint64_t numSnapshots = snapshots.size();
+
+    vector<int64_t> asks(numSnapshots);
+    vector<int64_t> bids(numSnapshots);
+    vector<int64_t> timestamps(numSnapshots);
+
+    for (size_t i = 0; i < numSnapshots; ++i)
+    {
+        const auto& snapshot = snapshots[i];
+
+        asks[i] = snapshot.ask.ticks;
+        bids[i] = snapshot.bid.ticks;
+        timestamps[i] = snapshot.timestamp;
+    }
+
+    const uint64_t columnSize = numSnapshots * sizeof(int64_t);
+
+    SnapshotFileHeader header{};
+    memcpy(header.magic, kSnapshotFileMagic, sizeof(header.magic));
+    header.version = kSnapshotFileVersion;
+    header.tickDecimals = kFixedPriceDecimals;
+    header.numSnapshots = numSnapshots;
+    header.askOffset = AlignColumnOffset(sizeof(header));
+    header.bidOffset = AlignColumnOffset(header.askOffset + columnSize);
+    header.timestampOffset = AlignColumnOffset(header.bidOffset + columnSize);
+
+    WriteFileAtomically(
+        path,
+        [&](ofstream& out)
+        {
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            WriteColumn(out, header.askOffset, asks);
+            WriteColumn(out, header.bidOffset, bids);
+            WriteColumn(out, header.timestampOffset, timestamps);
+        }
+    );
+}
+
+void WriteCompressedSnapshotFile(
+    const std::string& path, const std::vector<Snapshot>& snapshots
+)
+{
+    const uint64_t numSnapshots = snapshots.size();
+    const uint64_t numBlocks =
+        (numSnapshots + kSnapshotCodecBlockSize - 1) / kSnapshotCodecBlockSize;
+
+    CompressedSnapshotFileHeader header{};
+    memcpy(header.magic, kSnapshotFileMagic, sizeof(header.magic));
+    header.version = kCompressedSnapshotFileVersion;
+    header.tickDecimals = kFixedPriceDecimals;
+    header.numSnapshots = numSnapshots;
+    header.priceQuantum = GetPriceQuantum(snapshots);
+    header.blockSize = kSnapshotCodecBlockSize;
+    header.numBlocks = numBlocks;
+    header.blockOffsetsOffset = sizeof(header);
+
+    const uint64_t dataOffset =
+        header.blockOffsetsOffset + (numBlocks + 1) * sizeof(uint64_t);
+
+    vector<uint8_t> data;
+    vector<uint64_t> blockOffsets;
+    blockOffsets.reserve(numBlocks + 1);
+
+    for (uint64_t begin = 0; begin < numSnapshots; begin += kSnapshotCodecBlockSize)
+    {
+        const uint64_t count =
+            min<uint64_t>(kSnapshotCodecBlockSize, numSnapshots - begin);
+
+        blockOffsets.push_back(dataOffset + data.size());
+        EncodeSnapshotBlock(
+            span(snapshots).subspan(begin, count), header.priceQuantum, data
+        );
+    }
+    blockOffsets.push_back(dataOffset + data.size());
+
+    WriteFileAtomically(
+        path,
+        [&](ofstream& out)
+        {
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(
+                reinterpret_cast<const char*>(blockOffsets.data()),
+                blockOffsets.size() * sizeof(uint64_t)
+            );
+            out.write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+    );
+}
+
+int ConvertSnapshotJsonFilesToBinary(const std::string& root, bool isCompressed)
+{
+    int numConverted = 0;
+
+    for (const auto& entry : filesystem::recursive_directory_iterator(root))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".json")
+        {
+            continue;
+        }
+
+        const auto jsonPath = entry.path();
+        auto binaryPath = jsonPath;
+        binaryPath.replace_extension(".bin");
+
+        const vector<Snapshot> snapshots = ReadSnapshotsJsonFile(jsonPath.string());
+        if (isCompressed)
+        {
+            WriteCompressedSnapshotFile(binaryPath.string(), snapshots);
+        }
+        else
+        {
+            WriteSnapshotFile(binaryPath.string(), snapshots);
+        }
+
+        numConverted++;
+    }
+
+    return numConverted;
+}
+
+bool IsBinarySnapshotFileCurrent(
+    const std::string& binaryFilePath, const std::string& jsonFilePath
+)
+{
+    error_code error;
+    const auto binaryTime = filesystem::last_write_time(binaryFilePath, error);
+    if (error)
+    {
+        return false;
+    }
+
+    const auto jsonTime = filesystem::last_write_time(jsonFilePath, error);
+    if (error)
+    {
+        return true;  // converted days may have no JSON left
+    }
+
+    return binaryTime >= jsonTime;
+}
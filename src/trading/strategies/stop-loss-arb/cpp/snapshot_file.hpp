@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+// Columnar snapshot file, written next to each historical-data-80 JSON file as
+// <ticker>.bin: a SnapshotFileHeader followed by the ask, bid and timestamp columns,
+// each numSnapshots int64 values starting at a 64-byte aligned offset. Prices are
+// FixedPrice ticks with header.tickDecimals decimals; timestamps are epoch seconds.
+// Integers are stored in host (little-endian) byte order.
+//
+// The converter can instead write a compressed file (version 2): a
+// CompressedSnapshotFileHeader, numBlocks + 1 uint64 file offsets where the coded
+// blocks start (the last one is the end of the file), then the blocks coded by
+// EncodeSnapshotBlock. Any block can be decoded on its own.
+
+const char kSnapshotFileMagic[8] = {'D', 'H', 'S', 'N', 'A', 'P', '\0', '\0'};
+const uint32_t kSnapshotFileVersion = 1;
+const uint32_t kCompressedSnapshotFileVersion = 2;
+
+struct SnapshotFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t tickDecimals;
+    uint64_t numSnapshots;
+    uint64_t askOffset;
+    uint64_t bidOffset;
+    uint64_t timestampOffset;
+};
+
+struct CompressedSnapshotFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t tickDecimals;
+    uint64_t numSnapshots;
+    int64_t priceQuantum;
+    uint64_t blockSize;
+    uint64_t numBlocks;
+    uint64_t blockOffsetsOffset;
+};
+
+// Read-only memory mapping of a whole file, unmapped on destruction.
+struct MappedFile
+{
+    const std::byte* data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+};
+
+// Throws if the file cannot be opened or mapped.
+std::unique_ptr<MappedFile> MapFile(const std::string& path);
+
+struct SnapshotColumns
+{
+    std::span<const int64_t> asks;
+    std::span<const int64_t> bids;
+    std::span<const int64_t> timestamps;
+};
+
+struct MappedSnapshotFile
+{
+    std::unique_ptr<MappedFile> file;
+    SnapshotColumns columns;
+};
+
+// Throws if `file` (read from `path`) is not a snapshot file.
+uint32_t GetSnapshotFileVersion(const MappedFile& file, const std::string& path);
+
+// Maps a snapshot file and returns spans over its columns, without copying. Throws if
+// it is not a snapshot file of kSnapshotFileVersion or its ticks are not
+// kFixedPriceDecimals.
+MappedSnapshotFile MapSnapshotFile(const std::string& path);
+MappedSnapshotFile MapSnapshotFile(
+    std::unique_ptr<MappedFile> file, const std::string& path
+);
+
+struct MappedCompressedSnapshotFile
+{
+    std::unique_ptr<MappedFile> file;
+    CompressedSnapshotFileHeader header;
+    std::span<const uint64_t> blockOffsets;
+};
+
+// Like MapSnapshotFile, for kCompressedSnapshotFileVersion files.
+MappedCompressedSnapshotFile MapCompressedSnapshotFile(
+    std::unique_ptr<MappedFile> file, const std::string& path
+);
+
+// Decodes block `blockIndex` into `out`, which must hold header.blockSize snapshots
+// (fewer for the last block).
+void DecodeSnapshotFileBlock(
+    const MappedCompressedSnapshotFile& file,
+    size_t blockIndex,
+    std::span<Snapshot> out
+);
+
+void DecodeSnapshotFile(
+    const MappedCompressedSnapshotFile& file, std::vector<Snapshot>& snapshots
+);
+
+void WriteSnapshotFile(const std::string& path, const std::vector<Snapshot>& snapshots);
+
+void WriteCompressedSnapshotFile(
+    const std::string& path, const std::vector<Snapshot>& snapshots
+);
+
+// Writes <ticker>.bin next to every <ticker>.json under `root` (recursively), in the
+// compressed format if `isCompressed`, and returns how many files were converted.
+int ConvertSnapshotJsonFilesToBinary(const std::string& root, bool isCompressed);
+
+// Whether a .bin can be read in place of the .json it was converted from: it exists
+// and was written no earlier, so a re-downloaded JSON is not shadowed by a stale .bin.
+bool IsBinarySnapshotFileCurrent(
+    const std::string& binaryFilePath, const std::string& jsonFilePath
+);
@@ -2,11 +2,16 @@
 
 #include <chrono>
 #include <format>
-#include <future>
 
 #include "algo.hpp"
 #include "debug.hpp"
+#include "historical_pipeline.hpp"
+#include "numeric_conversions.hpp"
 #include "price_simulator.hpp"
+#include "quiet_band.hpp"
+#include "results_sink.hpp"
+#include "simulate_day.hpp"
+#include "work_stealing_pool.hpp"
 
 using namespace std;
 
@@ -17,22 +22,49 @@ void StartStopLossArbCpp(
     chrono::steady_clock::time_point start_time;
     start_time = chrono::high_resolution_clock::now();
 
-    vector<future<void>> waiting_for_dates_to_be_hedged;
-    waiting_for_dates_to_be_hedged.reserve(states_list.size());
-
     const string start_date = states_list[0].begin()->second.date;
     const string end_date = states_list[states_list.size() - 1].begin()->second.date;
 
-    for (auto& states : states_list)
+    if (IsHistoricalSnapshot() && !IsSpecializedKernelsDisabled())
     {
-        waiting_for_dates_to_be_hedged.push_back(
-            async(launch::async, StartStopLossArbCppHelper, ref(states))
-        );
+        RunHistoricalPipeline(states_list);
     }
-
-    for (const auto& future : waiting_for_dates_to_be_hedged)
+    else
     {
-        future.wait();
+        // One task per (date, ticker), so a few dates with many tickers keep every
+        // worker as busy as many dates with a few.
+        vector<pair<string, unordered_map<string, StockState>*>> stockDays;
+        for (auto& states : states_list)
+        {
+            for (const auto& [stock, _] : states)
+            {
+                stockDays.emplace_back(stock, &states);
+            }
+        }
+
+        RunOnWorkerPool(
+            stockDays.size(),
+            [&](size_t i)
+            {
+                const auto& [stock, states] = stockDays[i];
+
+                try
+                {
+                    HedgeStockWhileMarketIsOpen(stock, *states);
+                }
+                catch (const std::exception& e)
+                {
+                    Print(format(
+                        "Skipped {} on {}: {}", stock, states->at(stock).date, e.what()
+                    ));
+                }
+            }
+        );
+
+        if (IsHistoricalSnapshot())
+        {
+            FlushResults();
+        }
     }
 
     double elapsed_seconds;
@@ -51,47 +83,143 @@ void StartStopLossArbCpp(
     ));
 }
 
-void StartStopLossArbCppHelper(std::unordered_map<std::string, StockState>& states)
+bool IsSpecializedKernelsDisabled()
 {
-    for (const auto& stock_to_state_pair : states)
+    static const bool isSpecializedKernelsDisabled =
+        IsTruthyEnv("NO_SPECIALIZED_KERNELS");
+    return isSpecializedKernelsDisabled;
+}
+
+// HedgeStockWhileMarketIsOpenGeneric on random prices, with the interval mode and
+// ladder size resolved at compile time.
+template <bool kIsStaticIntervals, int kNumWords>
+void HedgeStockOnRandomPricesFor(const std::string& stock, StockState& stockState)
+{
+    SeedRandomWalk(stockState, stock);
+
+    const StockState originalState = stockState;
+
+    while (true)
     {
-        const auto& stock = stock_to_state_pair.first;
-        HedgeStockWhileMarketIsOpen(stock, states);
+        const Snapshot snapshot = GetRandomSnapshot(stockState.randomWalk);
+
+        ReconcileStockPositionOnSnapshotFor<kIsStaticIntervals, kNumWords>(
+            stock, stockState, snapshot
+        );
+
+        DebugRandomPrices(snapshot, stock, stockState, originalState);
     }
+}
+
+DayResult HedgeStockOnHistoricalDay(const std::string& stock, StockState& stockState)
+{
+    const DayResult result = SimulateHistoricalDay(stock, stockState);
+
+    AppendDayResult(stock, stockState, result);
+
+    return result;
+}
+
+DayResult SimulateHistoricalDay(const std::string& stock, StockState& stockState)
+{
+    LoadHistoricalSnapshots(stockState);
+
+    auto& historicalSnapshots = stockState.historicalSnapshots;
+    const auto& snapshots = *historicalSnapshots.data;
+
+    // Blocks are aligned to the start of the day.
+    const auto* blocks =
+        historicalSnapshots.index == 0 ? historicalSnapshots.blocks.get() : nullptr;
 
-    // Get a sorted list of stock keys
-    vector<string> sortedStocks;
-    for (const auto& [stock, _] : states)
+    const DayResult result = SimulateDay(
+        stock,
+        stockState,
+        span(snapshots).subspan(historicalSnapshots.index),
+        blocks
+    );
+
+    historicalSnapshots.index = static_cast<int>(snapshots.size());
+    historicalSnapshots.repeat = 0;
+
+    DeleteHistoricalSnapshots(stockState);
+
+    return result;
+}
+
+void HedgeStockWhileMarketIsOpen(
+    const std::string& stock, std::unordered_map<std::string, StockState>& states
+)
+{
+    const SnapshotSource source =
+        IsSpecializedKernelsDisabled() ? SnapshotSource::LIVE : GetSnapshotSource();
+
+    // Other stocks of the date run concurrently on the same map, so it is only read.
+    StockState& stockState = states.at(stock);
+
+    if (source == SnapshotSource::HISTORICAL)
     {
-        sortedStocks.push_back(stock);
+        HedgeStockOnHistoricalDay(stock, stockState);
     }
-    sort(sortedStocks.begin(), sortedStocks.end());
-
-    // Print results for each stock
-    for (const auto& stock : sortedStocks)
+    else if (source == SnapshotSource::RANDOM)
     {
-        const StockState& state = states[stock];
-
-        // PrintPnLValues(stock, state);
+        DispatchOnIntervalKernel(
+            stockState,
+            [&]<bool kIsStaticIntervals, int kNumWords>()
+            {
+                HedgeStockOnRandomPricesFor<kIsStaticIntervals, kNumWords>(
+                    stock, stockState
+                );
+            }
+        );
+    }
+    else
+    {
+        HedgeStockWhileMarketIsOpenGeneric(stock, states);
     }
 }
 
-void HedgeStockWhileMarketIsOpen(
+// The generic loop starts each day with no trading logs.
+DayResult GetGenericDayResult(const StockState& stockState)
+{
+    return GetDayResult(stockState, static_cast<int>(stockState.tradingLogs.size()));
+}
+
+void HedgeStockWhileMarketIsOpenGeneric(
     const std::string& stock, std::unordered_map<std::string, StockState>& states
 )
 {
-    const auto originalStates = states;  // clone original states
+    // Other stocks of the date run concurrently on the same map, so it is only read.
+    StockState& stockState = states.at(stock);
+
+    if (IsRandomSnapshot())
+    {
+        SeedRandomWalk(stockState, stock);
+    }
+
+    const StockState originalState = stockState;
 
     while (true)  // check if market is open when we move to cpp trading
     {
-        auto& stockState = states[stock];
+        // Blocks where no quote can cross or execute an interval are applied whole.
+        if (IsHistoricalSnapshot() && TryFastForwardQuietBlock(stockState))
+        {
+            if (IsHistoricalSnapshotsExhausted(stockState))
+            {
+                DeleteHistoricalSnapshots(stockState);
+                AppendDayResult(stock, stockState, GetGenericDayResult(stockState));
+
+                break;
+            }
+
+            continue;
+        }
 
         const auto snapshot = ReconcileStockPosition(stock, stockState);
 
         if (IsHistoricalSnapshot() && IsHistoricalSnapshotsExhausted(stockState))
         {
             DeleteHistoricalSnapshots(stockState);
-            WritePnLAsPercentagesToSnapshotsFile(stockState);
+            AppendDayResult(stock, stockState, GetGenericDayResult(stockState));
 
             break;
         }
@@ -113,14 +241,14 @@ void HedgeStockWhileMarketIsOpen(
 
         if (IsRandomSnapshot())
         {
-            DebugRandomPrices(snapshot, stock, states, originalStates);
+            DebugRandomPrices(snapshot, stock, stockState, originalState);
         }
     }
 }
 
-Decimal GetHistoricalProfitThreshold()
+FixedPrice GetHistoricalProfitThreshold()
 {
-    const auto default_historical_profit_threshold = GetDecimal(0.01);
+    const auto default_historical_profit_threshold = FixedPrice::FromDouble(0.01);
 
     const char* thresholdStr = getenv("HISTORICAL_PROFIT_THRESHOLD");
     if (thresholdStr == nullptr)
@@ -128,33 +256,27 @@ Decimal GetHistoricalProfitThreshold()
         return default_historical_profit_threshold;
     }
 
-    try
-    {
-        double value = stod(thresholdStr);
-        return GetDecimal(value);
-    }
-    catch (exception)
-    {
-        return default_historical_profit_threshold;
-    }
-    catch (...)
+    FixedPrice threshold{};
+    if (!TryParseFixedPrice(thresholdStr, threshold))
     {
         return default_historical_profit_threshold;
     }
+
+    return threshold;
 }
 
-const Decimal LIVE_PROFIT_THRESHOLD = GetDecimal(0.005);
-const Decimal LIVE_LOSS_THRESHOLD = -numeric_limits<double>::infinity();
+const FixedPrice LIVE_PROFIT_THRESHOLD = FixedPrice::FromDouble(0.005);
+const FixedPrice LIVE_LOSS_THRESHOLD = FixedPrice::Min();
 
 bool IsExitPnlBeyondThresholds(const StockState& stockState)
 {
     return false;
 
-    const Decimal& exitPnLAsPercentage = stockState.exitPnLAsPercentage;
+    const FixedPrice& exitPnLAsPercentage = stockState.exitPnLAsPercentage;
 
     if (IsHistoricalSnapshot())
     {
-        Decimal historicalProfitThreshold = GetHistoricalProfitThreshold();
+        FixedPrice historicalProfitThreshold = GetHistoricalProfitThreshold();
         if (exitPnLAsPercentage >= historicalProfitThreshold)
         {
             return true;
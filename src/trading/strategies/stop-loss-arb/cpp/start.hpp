@@ -10,10 +10,25 @@ void StartStopLossArbCpp(
     std::vector<std::unordered_map<std::string, StockState>>& states_list
 );
 
-void StartStopLossArbCppHelper(std::unordered_map<std::string, StockState>& states);
-
+// Historical days run through SimulateDay and random prices through a loop
+// specialized for the interval mode and ladder size; live trading (and
+// NO_SPECIALIZED_KERNELS) uses the generic loop.
 void HedgeStockWhileMarketIsOpen(
     const std::string& stock, std::unordered_map<std::string, StockState>& states
 );
 
+// NO_SPECIALIZED_KERNELS: always run the generic hedge loop.
+bool IsSpecializedKernelsDisabled();
+
+void HedgeStockWhileMarketIsOpenGeneric(
+    const std::string& stock, std::unordered_map<std::string, StockState>& states
+);
+
+// Simulates the stock's whole historical day and appends its result to the results
+// sink.
+DayResult HedgeStockOnHistoricalDay(const std::string& stock, StockState& stockState);
+
+// HedgeStockOnHistoricalDay without recording the result.
+DayResult SimulateHistoricalDay(const std::string& stock, StockState& stockState);
+
 bool IsExitPnlBeyondThresholds(const StockState& stockState);
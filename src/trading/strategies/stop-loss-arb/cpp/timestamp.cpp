@@ -0,0 +1,156 @@
+#include "timestamp.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <format>
+
+using namespace std;
+using namespace std::chrono;
+
+const int64_t kSecondsPerHour = 60 * 60;
+const int64_t kSecondsPerDay = 24 * kSecondsPerHour;
+
+// Daylight saving runs from 2am EST on the second Sunday of March to 2am EDT on the
+// first Sunday of November. Both bounds as UTC epoch seconds.
+struct DaylightSavingBounds
+{
+    int64_t begin;
+    int64_t end;
+};
+
+DaylightSavingBounds GetDaylightSavingBounds(int yearNumber)
+{
+    const year y{yearNumber};
+    const sys_days dstBegin{y / March / Sunday[2]};
+    const sys_days dstEnd{y / November / Sunday[1]};
+
+    return DaylightSavingBounds{
+        dstBegin.time_since_epoch().count() * kSecondsPerDay + 7 * kSecondsPerHour,
+        dstEnd.time_since_epoch().count() * kSecondsPerDay + 6 * kSecondsPerHour
+    };
+}
+
+bool TryParseNumber(string_view& text, size_t numDigits, int& result)
+{
+    if (text.size() < numDigits)
+    {
+        return false;
+    }
+
+    const char* end = text.data() + numDigits;
+    const auto [ptr, error] = from_chars(text.data(), end, result);
+    if (error != errc{} || ptr != end)
+    {
+        return false;
+    }
+
+    text.remove_prefix(numDigits);
+    return true;
+}
+
+bool TrySkip(string_view& text, string_view expected)
+{
+    if (!text.starts_with(expected))
+    {
+        return false;
+    }
+
+    text.remove_prefix(expected.size());
+    return true;
+}
+
+bool TryParseEasternTimestamp(std::string_view text, int64_t& epochSeconds)
+{
+    int yearNumber = 0;
+    int monthNumber = 0;
+    int dayNumber = 0;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+
+    if (!TryParseNumber(text, 4, yearNumber) || !TrySkip(text, "-") ||
+        !TryParseNumber(text, 2, monthNumber) || !TrySkip(text, "-") ||
+        !TryParseNumber(text, 2, dayNumber) ||
+        !(TrySkip(text, " at ") || TrySkip(text, " ")) ||
+        !TryParseNumber(text, 2, hour) || !TrySkip(text, ":") ||
+        !TryParseNumber(text, 2, minute) || !TrySkip(text, ":") ||
+        !TryParseNumber(text, 2, second))
+    {
+        return false;
+    }
+
+    bool isPm = false;
+    if (TrySkip(text, "pm"))
+    {
+        isPm = true;
+    }
+    else if (!TrySkip(text, "am"))
+    {
+        return false;
+    }
+
+    if (text != " ET" || hour < 1 || hour > 12 || minute > 59 || second > 59)
+    {
+        return false;
+    }
+
+    const year_month_day date{year{yearNumber}, month(monthNumber), day(dayNumber)};
+    if (!date.ok())
+    {
+        return false;
+    }
+
+    const int hour24 = (hour % 12) + (isPm ? 12 : 0);
+    const int64_t wallClockSeconds =
+        sys_days{date}.time_since_epoch().count() * kSecondsPerDay +
+        hour24 * kSecondsPerHour + minute * 60 + second;
+
+    // Wall-clock bounds of daylight saving are 2am on both dates; clocks jump from 2am
+    // to 3am at the start.
+    const auto bounds = GetDaylightSavingBounds(yearNumber);
+    if (wallClockSeconds >= bounds.begin - 5 * kSecondsPerHour &&
+        wallClockSeconds < bounds.begin - 4 * kSecondsPerHour)
+    {
+        return false;
+    }
+
+    const bool isDaylightSaving =
+        wallClockSeconds >= bounds.begin - 5 * kSecondsPerHour &&
+        wallClockSeconds < bounds.end - 4 * kSecondsPerHour;
+
+    epochSeconds = wallClockSeconds + (isDaylightSaving ? 4 : 5) * kSecondsPerHour;
+
+    return true;
+}
+
+std::string FormatEasternTimestamp(int64_t epochSeconds)
+{
+    const sys_days utcDay{days{epochSeconds / kSecondsPerDay}};
+    const auto bounds = GetDaylightSavingBounds(int(year_month_day{utcDay}.year()));
+    const bool isDaylightSaving =
+        epochSeconds >= bounds.begin && epochSeconds < bounds.end;
+
+    const int64_t wallClockSeconds =
+        epochSeconds - (isDaylightSaving ? 4 : 5) * kSecondsPerHour;
+
+    const sys_days wallClockDay{days{wallClockSeconds / kSecondsPerDay}};
+    const year_month_day date{wallClockDay};
+
+    const int64_t secondOfDay = wallClockSeconds % kSecondsPerDay;
+    const int hour24 = static_cast<int>(secondOfDay / kSecondsPerHour);
+    const int minute = static_cast<int>(secondOfDay % kSecondsPerHour / 60);
+    const int second = static_cast<int>(secondOfDay % 60);
+
+    const int hour = hour24 % 12 == 0 ? 12 : hour24 % 12;
+
+    return format(
+        "{:04}-{:02}-{:02} {:02}:{:02}:{:02}{} ET",
+        int(date.year()),
+        unsigned(date.month()),
+        unsigned(date.day()),
+        hour,
+        minute,
+        second,
+        hour24 < 12 ? "am" : "pm"
+    );
+}
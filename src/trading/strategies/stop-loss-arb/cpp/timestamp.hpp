@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Snapshot and trading log timestamps are held as Unix epoch seconds and only turned
+// into text when exported to JS. The text form is US Eastern wall-clock time,
+// "2023-11-09 09:40:00am ET", switching between EST and EDT on the US daylight saving
+// dates.
+
+// Also reads the live trading form, "2023-11-09 at 09:40:00am ET". Returns false for
+// any other text and for wall-clock times skipped when daylight saving starts, so
+// FormatEasternTimestamp gives back the parsed text (in the first form).
+bool TryParseEasternTimestamp(std::string_view text, int64_t& epochSeconds);
+
+std::string FormatEasternTimestamp(int64_t epochSeconds);
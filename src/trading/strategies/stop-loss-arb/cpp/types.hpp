@@ -1,14 +1,24 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <optional>
+#include <string>
+#include <vector>
 
-#include "utils.hpp"
+#include "fixed_price.hpp"
+#include "interval_mask.hpp"
+#include "philox.hpp"
 
 struct Snapshot
 {
-    Decimal ask;
-    Decimal bid;
-    std::string timestamp;
+    FixedPrice ask;
+    FixedPrice bid;
+    // Epoch seconds; see timestamp.hpp for the text form.
+    int64_t timestamp;
+    // Seconds in a row the quote held for, from `timestamp` on. Loaded historical
+    // days are collapsed this way (see repeated_quotes.hpp); otherwise 1.
+    int repeatCount = 1;
 };
 
 enum class IntervalType
@@ -17,15 +27,24 @@ enum class IntervalType
     SHORT
 };
 
+// Where the hedge loop takes its quotes from, picked once per stock/day from the
+// RANDOM_SNAPSHOT and HISTORICAL_SNAPSHOT env variables.
+enum class SnapshotSource
+{
+    RANDOM,
+    HISTORICAL,
+    LIVE
+};
+
 struct SmoothingInterval
 {
     struct OrderActionDetails
     {
         bool active;
         bool crossed;
-        Decimal price;
-        std::optional<Decimal> boughtAtPrice;
-        std::optional<Decimal> soldAtPrice;
+        FixedPrice price;
+        std::optional<FixedPrice> boughtAtPrice;
+        std::optional<FixedPrice> soldAtPrice;
     };
 
     IntervalType type;
@@ -34,19 +53,131 @@ struct SmoothingInterval
     OrderActionDetails BUY;
 };
 
+// prices[begin + j] == top - j * step for j in [0, end - begin).
+struct PriceSegment
+{
+    int begin;
+    int end;
+    FixedPrice top;
+    FixedPrice step;
+};
+
+// Lookup structure for a ladder base price array. getFullStockState lays the levels out
+// strictly descending with uniform spacing on each side of the initial price, so the
+// array splits into a couple of arithmetic segments and the number of levels above a
+// quote is a division per segment. Other strictly descending layouts fall back to a
+// binary search; anything else is not indexed and is scanned.
+struct PriceIndex
+{
+    bool isDescending = false;
+    std::vector<PriceSegment> segments;
+};
+
+// The intervals as a structure of arrays, ordered like StockState::intervals used to
+// be (index 0 is the top LONG interval). The BUY/SELL active and crossed flags are
+// bitsets, so selecting and flipping intervals is word-wide mask arithmetic. The
+// bindings convert to and from std::vector<SmoothingInterval> (see
+// interval_ladder.hpp).
+struct IntervalLadder
+{
+    std::vector<IntervalType> types;
+    std::vector<int> positionLimits;
+    // Level prices are stored relative to priceOffset, so re-centering the ladder is
+    // a single add; GetBuyPrice/GetSellPrice give the absolute price.
+    std::vector<FixedPrice> buyBasePrices;
+    std::vector<FixedPrice> sellBasePrices;
+    FixedPrice priceOffset;
+    std::vector<std::optional<FixedPrice>> boughtAtPrices;  // SELL.boughtAtPrice
+    std::vector<std::optional<FixedPrice>> soldAtPrices;    // BUY.soldAtPrice
+
+    PriceIndex buyPriceIndex;
+    PriceIndex sellPriceIndex;
+
+    IntervalMask buyActive;
+    IntervalMask buyCrossed;
+    IntervalMask sellActive;
+    IntervalMask sellCrossed;
+
+    // Scratch masks, kept here so reconciling a snapshot does not allocate.
+    // toExecute holds the intervals picked by the last GetNumToBuy/GetNumToSell.
+    IntervalMask toExecute;
+    IntervalMask priceMatches;
+
+    int size() const { return static_cast<int>(types.size()); }
+};
+
 struct TradingLog
 {
-    std::string timeStamp;
+    int64_t timeStamp;
     std::string action;
-    Decimal price;
+    FixedPrice price;
     int previousPosition;
     int newPosition;
 };
 
+// Extremes of a run of kSnapshotBlockSize consecutive historical snapshots.
+struct SnapshotBlock
+{
+    FixedPrice minAsk;
+    FixedPrice maxAsk;
+    FixedPrice minBid;
+    FixedPrice maxBid;
+    FixedPrice maxSpread;
+};
+
+// Shared, read-only views into the day's cached SnapshotDataset.
 struct HistoricalSnapshots
 {
-    std::vector<Snapshot>* data = nullptr;
+    std::shared_ptr<const std::vector<Snapshot>> data;
+    std::shared_ptr<const std::vector<SnapshotBlock>> blocks;
     int index = 0;
+    int repeat = 0;  // second within data[index] that GetHistoricalSnapshot is at
+};
+
+// A stock's random-snapshot price path. Ticks come from a Philox stream keyed by the
+// run's seed, the stock and the date, so a run replays exactly from its seed however
+// the stocks are scheduled. Directions are drawn a block at a time.
+struct RandomWalk
+{
+    bool isSeeded = false;
+    PhiloxKey key{};
+    uint64_t path = 0;   // bumped on every restart, so each one walks fresh ticks
+    uint64_t block = 0;  // next Philox counter on the path
+    FixedPrice price;
+    uint64_t tickDowns = 0;  // buffered directions, next in the lowest bit
+    int numBufferedTicks = 0;
+};
+
+// Running totals over the open intervals (LONG with SELL active, SHORT with BUY
+// active), kept in step with the interval flags so exit PnL needs no interval scan.
+struct OpenPositionTotals
+{
+    bool initialized = false;
+    int numLongs = 0;
+    FixedPrice boughtAtPriceSum;
+    int numShorts = 0;
+    FixedPrice soldAtPriceSum;
+    int numWithoutPrice = 0;  // open intervals whose fill price was never set
+};
+
+// Outcome of a simulated day, from SimulateDay.
+struct DayResult
+{
+    int position;
+    int numTrades;
+    FixedPrice realizedPnL;
+    FixedPrice exitPnL;
+    FixedPrice exitPnLAsPercentage;
+    FixedPrice maxMovingProfitAsPercentage;
+    FixedPrice maxMovingLossAsPercentage;
+    bool reached_1_percentage_profit;
+    FixedPrice max_loss_when_reached_1_percentage_profit;
+    bool reached_0_75_percentage_profit;
+    FixedPrice max_loss_when_reached_0_75_percentage_profit;
+    bool reached_0_5_percentage_profit;
+    FixedPrice max_loss_when_reached_0_5_percentage_profit;
+    bool reached_0_25_percentage_profit;
+    FixedPrice max_loss_when_reached_0_25_percentage_profit;
 };
 
 struct StockState
@@ -54,31 +185,33 @@ struct StockState
     std::string date;
     bool isStaticIntervals;
     std::string brokerageId;
-    Decimal brokerageTradingCostPerShare;
+    FixedPrice brokerageTradingCostPerShare;
     int sharesPerInterval;
-    Decimal intervalProfit;
-    Decimal initialPrice;
+    FixedPrice intervalProfit;
+    FixedPrice initialPrice;
     int shiftIntervalsFromInitialPrice;
-    Decimal spaceBetweenIntervals;
+    FixedPrice spaceBetweenIntervals;
     int numContracts;
     int position;
     int targetPosition;
-    Decimal realizedPnL;
-    Decimal exitPnL;
-    Decimal exitPnLAsPercentage;
-    Decimal maxMovingProfitAsPercentage;
-    Decimal maxMovingLossAsPercentage;
+    FixedPrice realizedPnL;
+    FixedPrice exitPnL;
+    FixedPrice exitPnLAsPercentage;
+    FixedPrice maxMovingProfitAsPercentage;
+    FixedPrice maxMovingLossAsPercentage;
     bool reached_1_percentage_profit;
-    Decimal max_loss_when_reached_1_percentage_profit;
+    FixedPrice max_loss_when_reached_1_percentage_profit;
     bool reached_0_75_percentage_profit;
-    Decimal max_loss_when_reached_0_75_percentage_profit;
+    FixedPrice max_loss_when_reached_0_75_percentage_profit;
     bool reached_0_5_percentage_profit;
-    Decimal max_loss_when_reached_0_5_percentage_profit;
+    FixedPrice max_loss_when_reached_0_5_percentage_profit;
     bool reached_0_25_percentage_profit;
-    Decimal max_loss_when_reached_0_25_percentage_profit;
-    Decimal lastAsk;
-    Decimal lastBid;
-    std::vector<SmoothingInterval> intervals;
+    FixedPrice max_loss_when_reached_0_25_percentage_profit;
+    FixedPrice lastAsk;
+    FixedPrice lastBid;
+    IntervalLadder intervals;
+    OpenPositionTotals openPositionTotals;
     std::vector<TradingLog> tradingLogs;
     HistoricalSnapshots historicalSnapshots;
+    RandomWalk randomWalk;
 };
@@ -0,0 +1,215 @@
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct WorkerDeque
+{
+    mutex lock;
+    deque<size_t> tasks;
+};
+
+struct WorkStealingPool
+{
+    vector<unique_ptr<WorkerDeque>> deques;
+    vector<thread> workers;
+
+    mutex runLock;  // one RunOnWorkerPool at a time
+
+    mutex lock;
+    condition_variable workAvailable;
+    condition_variable workDone;
+    const function<void(size_t)>* task = nullptr;
+    uint64_t generation = 0;
+    size_t numRemaining = 0;
+    int numActiveWorkers = 0;
+    exception_ptr error;
+    bool isStopping = false;
+
+    explicit WorkStealingPool(int numWorkers)
+    {
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            deques.push_back(make_unique<WorkerDeque>());
+        }
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            workers.emplace_back([this, i]() { Work(i); });
+        }
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            isStopping = true;
+        }
+        workAvailable.notify_all();
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    optional<size_t> TakeTask(int worker)
+    {
+        {
+            WorkerDeque& own = *deques[worker];
+            lock_guard<mutex> guard(own.lock);
+
+            if (!own.tasks.empty())
+            {
+                const size_t index = own.tasks.back();
+                own.tasks.pop_back();
+                return index;
+            }
+        }
+
+        const int numWorkers = static_cast<int>(deques.size());
+        for (int offset = 1; offset < numWorkers; ++offset)
+        {
+            WorkerDeque& victim = *deques[(worker + offset) % numWorkers];
+            lock_guard<mutex> guard(victim.lock);
+
+            if (!victim.tasks.empty())
+            {
+                const size_t index = victim.tasks.front();
+                victim.tasks.pop_front();
+                return index;
+            }
+        }
+
+        return nullopt;
+    }
+
+    void Work(int worker)
+    {
+        uint64_t seenGeneration = 0;
+
+        while (true)
+        {
+            const function<void(size_t)>* currentTask;
+            {
+                unique_lock<mutex> guard(lock);
+                workAvailable.wait(
+                    guard, [&]() { return isStopping || generation != seenGeneration; }
+                );
+
+                if (isStopping)
+                {
+                    return;
+                }
+
+                seenGeneration = generation;
+
+                // Woken for a call that has already returned: its deques are empty,
+                // and the next call's are filled only along with its `task`.
+                if (task == nullptr)
+                {
+                    continue;
+                }
+
+                currentTask = task;
+                numActiveWorkers++;
+            }
+
+            while (const auto index = TakeTask(worker))
+            {
+                try
+                {
+                    (*currentTask)(*index);
+                }
+                catch (...)
+                {
+                    lock_guard<mutex> guard(lock);
+                    if (!error)
+                    {
+                        error = current_exception();
+                    }
+                }
+
+                lock_guard<mutex> guard(lock);
+                numRemaining--;
+            }
+
+            // Only idle workers count as done, so none is still taking tasks with
+            // this call's `task` when the next call fills the deques. Workers that
+            // never picked this call up do not take tasks (see above).
+            {
+                lock_guard<mutex> guard(lock);
+                numActiveWorkers--;
+            }
+            workDone.notify_all();
+        }
+    }
+
+    void Run(size_t numTasks, const function<void(size_t)>& runTask)
+    {
+        lock_guard<mutex> runGuard(runLock);
+
+        exception_ptr runError;
+        {
+            unique_lock<mutex> guard(lock);
+
+            // Filled under `lock`, so a worker sees the tasks only with their `task`
+            // and count.
+            const size_t numWorkers = deques.size();
+            for (size_t worker = 0; worker < numWorkers; ++worker)
+            {
+                WorkerDeque& own = *deques[worker];
+                lock_guard<mutex> dequeGuard(own.lock);
+
+                for (size_t i = worker * numTasks / numWorkers;
+                     i < (worker + 1) * numTasks / numWorkers;
+                     ++i)
+                {
+                    own.tasks.push_back(i);
+                }
+            }
+
+            task = &runTask;
+            numRemaining = numTasks;
+            error = nullptr;
+            generation++;
+            workAvailable.notify_all();
+
+            workDone.wait(
+                guard, [&]() { return numRemaining == 0 && numActiveWorkers == 0; }
+            );
+
+            task = nullptr;
+            runError = error;
+        }
+
+        if (runError)
+        {
+            rethrow_exception(runError);
+        }
+    }
+};
+
+int GetWorkerPoolSize()
+{
+    return max(1, static_cast<int>(thread::hardware_concurrency()));
+}
+
+void RunOnWorkerPool(size_t numTasks, const std::function<void(size_t)>& task)
+{
+    static WorkStealingPool pool(GetWorkerPoolSize());
+
+    if (numTasks > 0)
+    {
+        pool.Run(numTasks, task);
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Runs task(i) for every i in [0, numTasks) on a process-wide pool with one worker per
+// hardware thread, and returns once all of them are done. Each worker starts on its
+// own contiguous share of the indices, taking from the back of its deque, and once
+// that is empty steals from the front of the others', so uneven tasks still keep
+// every core busy. Rethrows the first exception a task threw, after the rest ran.
+//
+// Calls from several threads take turns; a task must not call it again.
+void RunOnWorkerPool(size_t numTasks, const std::function<void(size_t)>& task);
+
+int GetWorkerPoolSize();
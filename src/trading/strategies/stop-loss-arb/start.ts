@@ -28,6 +28,16 @@ export async function startStopLossArb(): Promise<void> {
     } else {
         const datesArrayCppPartitions = await getDatesArrayCppPartitions();
 
+        // PARAMETER_SWEEP_GRID: JSON file of {spaceBetweenIntervals, intervalProfit,
+        // sharesPerInterval, targetPosition} value arrays to sweep every date over
+        if (process.env.PARAMETER_SWEEP_GRID) {
+            await sweepHistoricalDatesOnCpp(
+                datesArrayCppPartitions.flat(),
+                process.env.PARAMETER_SWEEP_GRID,
+            );
+            return;
+        }
+
         for (const dates of datesArrayCppPartitions) {
             await runHistoricalDatesOnCpp(dates);
         }
@@ -51,6 +61,22 @@ async function runHistoricalDatesOnCpp(dates: string[]): Promise<void> {
     addon.JsStartStopLossArbCpp(statesList);
 }
 
+async function sweepHistoricalDatesOnCpp(dates: string[], gridFilePath: string): Promise<void> {
+    const grid = await readJSONFile<{
+        spaceBetweenIntervals: number[],
+        intervalProfit: number[],
+        sharesPerInterval: number[],
+        targetPosition: number[],
+    }>(gridFilePath);
+
+    const statesList: { [stock: string]: StockState }[] = [];
+    for (const date of dates) {
+        statesList.push(await getHistoricalCppStockStates(date));
+    }
+
+    console.table(addon.JsRunParameterSweep(statesList, grid));
+}
+
 async function startStopLossArbNode(
     stocks: string[],
     states: { [stock: string]: StockState },
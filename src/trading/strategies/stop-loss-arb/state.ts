@@ -46,13 +46,54 @@ export async function getHistoricalCppStockStates(
     const year = date.split('-')[0];
     const month = date.split('-')[1];
 
+    const stockStates: { [stock: string]: StockState } = {};
+
+    // Loaded here rather than at the top, so importing this module does not need the
+    // built addon (live trading, new-state.ts)
+    const addon = require('bindings')('deephedge');
+
     const cwd = process.cwd();
     const dir = path.join(cwd, '..', 'deephedge', 'historical-data-80', year, month, date);
 
     const files = await fs.readdir(dir);
-    const jsonFiles = files.filter(file => file.endsWith('.json'));
+    const folderTickers = new Set(
+        files
+            .filter(file => file.endsWith('.json') || file.endsWith('.bin'))
+            .map(file => path.parse(file).name),
+    );
+
+    // The dataset manifest (build_dataset_manifest.js) has everything needed here, so
+    // only the day's files it does not know about are parsed. Listing the folder is
+    // cheap and catches tickers added or removed since the manifest was built
+    const manifestEntries = addon.JsGetDatasetManifestEntriesOnDate(date) as {ticker: string, firstAsk: number}[];
+    const removedTickers: string[] = [];
+    for (const {ticker, firstAsk} of manifestEntries) {
+        if (!folderTickers.has(ticker)) {
+            removedTickers.push(ticker);
+            continue;
+        }
+
+        stockStates[ticker] = getHistoricalCppStockState(date, ticker, firstAsk);
+    }
+
+    const addedTickers = [...folderTickers].filter(ticker => !(ticker in stockStates));
+    if (manifestEntries.length > 0 && (addedTickers.length > 0 || removedTickers.length > 0)) {
+        console.warn(
+            `Dataset manifest is out of date for ${date} ` +
+            `(added: ${addedTickers.join(', ') || '-'}, removed: ${removedTickers.join(', ') || '-'}); ` +
+            'run build_dataset_manifest.js',
+        );
+    }
+
+    const binOnlyTickers = addedTickers.filter(ticker => !files.includes(`${ticker}.json`));
+    if (binOnlyTickers.length > 0) {
+        console.warn(`Skipping ${binOnlyTickers.join(', ')} on ${date}: only a .bin file, and not in the dataset manifest`);
+    }
+
+    const jsonFiles = addedTickers
+        .filter(ticker => files.includes(`${ticker}.json`))
+        .map(ticker => `${ticker}.json`);
 
-    const stockStates: { [stock: string]: StockState } = {};
     for (const file of jsonFiles) {
         const filePath = path.join(dir, file);
 
@@ -64,25 +105,31 @@ export async function getHistoricalCppStockStates(
             throw error;
         }
 
-        const stockState = getFullStockState({
+        stockStates[stock_file_data.ticker] = getHistoricalCppStockState(
             date,
-            brokerageId: stock_file_data.ticker,
-            brokerageTradingCostPerShare: 0, // 0.004,
-            numContracts: 1,
-            initialPrice: stock_file_data.snapshots[0].ask,
-            shiftIntervalsFromInitialPrice: 0,
-            targetPosition: 100,
-            sharesPerInterval: 25,
-            spaceBetweenIntervals: fc.multiply(0.02, 2),
-            intervalProfit: 0.02,
-        } as unknown as StockState);
-
-        stockStates[stock_file_data.ticker] = stockState;
+            stock_file_data.ticker,
+            stock_file_data.snapshots[0].ask,
+        );
     }
 
     return stockStates;
 }
 
+function getHistoricalCppStockState(date: string, ticker: string, initialPrice: number): StockState {
+    return getFullStockState({
+        date,
+        brokerageId: ticker,
+        brokerageTradingCostPerShare: 0, // 0.004,
+        numContracts: 1,
+        initialPrice,
+        shiftIntervalsFromInitialPrice: 0,
+        targetPosition: 100,
+        sharesPerInterval: 25,
+        spaceBetweenIntervals: fc.multiply(0.02, 2),
+        intervalProfit: 0.02,
+    } as unknown as StockState);
+}
+
 export function getStockStateFilePath(stock: string): string {
     return `${getStockStatesFolderPath()}\\${stock}.json`;
 }
@@ -0,0 +1,204 @@
+var {expect} = require('chai');
+var addon = require('bindings')('deephedge');
+
+// Run with: yarn test-cpp (after yarn cpp)
+
+describe('TryParseFixedPrice', function () {
+    it('parses prices to the tick', function () {
+        expect(addon.JsTestParseFixedPrice('9.37')).to.equal('9.37');
+        expect(addon.JsTestParseFixedPrice('-0.5')).to.equal('-0.5');
+        expect(addon.JsTestParseFixedPrice('1e-05')).to.equal('0.00001');
+        expect(addon.JsTestParseFixedPrice('123456.000001')).to.equal('123456.000001');
+    });
+
+    it('rounds digits past the tick half away from zero', function () {
+        expect(addon.JsTestParseFixedPrice('1.0000005')).to.equal('1.000001');
+        expect(addon.JsTestParseFixedPrice('-1.0000005')).to.equal('-1.000001');
+        expect(addon.JsTestParseFixedPrice('1.00000049')).to.equal('1');
+        expect(addon.JsTestParseFixedPrice('0.0000004')).to.equal('0');
+        expect(addon.JsTestParseFixedPrice('9.3699999999')).to.equal('9.37');
+    });
+
+    it('rejects text that is not a price', function () {
+        expect(addon.JsTestParseFixedPrice('')).to.be.null;
+        expect(addon.JsTestParseFixedPrice('abc')).to.be.null;
+        expect(addon.JsTestParseFixedPrice('9.37x')).to.be.null;
+        expect(addon.JsTestParseFixedPrice('1e30')).to.be.null;
+    });
+});
+
+describe('Eastern timestamps', function () {
+    var parse = addon.JsTestParseEasternTimestamp;
+    var format = addon.JsTestFormatEasternTimestamp;
+
+    it('parses both the snapshot and the live trading form', function () {
+        expect(parse('2023-11-09 09:40:00am ET')).to.equal(1699540800);
+        expect(parse('2023-11-09 at 09:40:00am ET')).to.equal(1699540800);
+        expect(format(1699540800)).to.equal('2023-11-09 09:40:00am ET');
+    });
+
+    it('reads 12 o\'clock as noon in pm and midnight in am', function () {
+        expect(parse('2023-11-09 12:00:00pm ET')).to.equal(1699549200);
+        expect(parse('2023-11-09 12:30:00pm ET')).to.equal(1699551000);
+        expect(parse('2023-11-09 12:00:00am ET')).to.equal(1699506000);
+        expect(format(1699549200)).to.equal('2023-11-09 12:00:00pm ET');
+        expect(format(1699506000)).to.equal('2023-11-09 12:00:00am ET');
+    });
+
+    it('rejects the hour skipped when daylight saving starts', function () {
+        expect(parse('2024-03-10 01:59:59am ET')).to.equal(1710053999);
+        expect(parse('2024-03-10 02:00:00am ET')).to.be.null;
+        expect(parse('2024-03-10 02:59:59am ET')).to.be.null;
+        expect(parse('2024-03-10 03:00:00am ET')).to.equal(1710054000);
+        expect(format(1710054000)).to.equal('2024-03-10 03:00:00am ET');
+    });
+
+    it('reads the hour repeated when daylight saving ends as EDT', function () {
+        expect(parse('2024-11-03 01:30:00am ET')).to.equal(1730611800);
+        expect(format(1730611800)).to.equal('2024-11-03 01:30:00am ET');
+        expect(format(1730615400)).to.equal('2024-11-03 01:30:00am ET');
+        expect(parse('2024-11-03 02:00:00am ET')).to.equal(1730617200);
+    });
+
+    it('round-trips every quarter hour of a year', function () {
+        // The EST pass of 2024-11-03 01:00-02:00am.
+        var repeatedHourBegin = 1730613600;
+        var repeatedHourEnd = 1730617200;
+        for (var t = 1704085200; t < 1735707600; t += 900) {
+            var expected =
+                t >= repeatedHourBegin && t < repeatedHourEnd ? t - 3600 : t;
+            expect(parse(format(t)), format(t)).to.equal(expected);
+        }
+    });
+
+    it('rejects malformed text', function () {
+        expect(parse('2023-11-09 13:00:00pm ET')).to.be.null;
+        expect(parse('2023-11-09 00:00:00am ET')).to.be.null;
+        expect(parse('2023-02-30 09:40:00am ET')).to.be.null;
+        expect(parse('2023-11-09 09:40:00am')).to.be.null;
+        expect(parse('2023-11-09 9:40:00am ET')).to.be.null;
+    });
+});
+
+describe('Snapshot block codec', function () {
+    function getSnapshots(numSnapshots, seed) {
+        // Small LCG so that failures replay.
+        var state = seed;
+        function random() {
+            state = (state * 1103515245 + 12345) % 2147483648;
+            return state / 2147483648;
+        }
+
+        var snapshots = [];
+        var askCents = 937;
+        var timestamp = 1699540800;
+        for (var i = 0; i < numSnapshots; i++) {
+            var move = random();
+            if (move < 0.05) {
+                askCents += Math.floor(random() * 2000) - 1000;
+            } else if (move < 0.5) {
+                askCents += Math.floor(random() * 5) - 2;
+            }
+            askCents = Math.max(askCents, 1);
+
+            var spreadCents = Math.floor(random() * 4);
+            var bidCents = random() < 0.01 ? 0 : Math.max(askCents - spreadCents, 0);
+            timestamp += random() < 0.01 ? 3600 : 1;
+
+            snapshots.push({
+                ask: (askCents / 100).toFixed(2),
+                bid: (bidCents / 100).toFixed(2),
+                timestamp: timestamp,
+            });
+        }
+
+        return snapshots;
+    }
+
+    function normalize(snapshots) {
+        return snapshots.map((snapshot) => ({
+            ask: addon.JsTestParseFixedPrice(snapshot.ask),
+            bid: addon.JsTestParseFixedPrice(snapshot.bid),
+            timestamp: snapshot.timestamp,
+        }));
+    }
+
+    function roundTrip(snapshots) {
+        var block = addon.JsTestEncodeSnapshotBlock(snapshots);
+        var quantum = addon.JsTestGetPriceQuantum(snapshots);
+
+        return addon.JsTestDecodeSnapshotBlock(block, quantum, snapshots.length);
+    }
+
+    it('takes the largest price unit dividing every ask and bid', function () {
+        var cents = [{ask: '9.37', bid: '9.36', timestamp: 0}];
+        expect(addon.JsTestGetPriceQuantum(cents)).to.equal('0.01');
+
+        var halfCents = cents.concat([{ask: '9.375', bid: '9.37', timestamp: 1}]);
+        expect(addon.JsTestGetPriceQuantum(halfCents)).to.equal('0.005');
+
+        var dollars = [{ask: '12', bid: '10', timestamp: 0}];
+        expect(addon.JsTestGetPriceQuantum(dollars)).to.equal('2');
+
+        var zeros = [{ask: '0', bid: '0', timestamp: 0}];
+        expect(addon.JsTestGetPriceQuantum(zeros)).to.equal('0.000001');
+    });
+
+    it('round-trips a day of quotes', function () {
+        var snapshots = getSnapshots(5000, 42);
+        expect(roundTrip(snapshots)).to.deep.equal(normalize(snapshots));
+    });
+
+    it('round-trips falling prices, zero bids and sub-cent ticks', function () {
+        var snapshots = [
+            {ask: '100.000001', bid: '99.999999', timestamp: 1699540800},
+            {ask: '0.000002', bid: '0', timestamp: 1699540801},
+            {ask: '50', bid: '0.000001', timestamp: 1699540799},
+            {ask: '0', bid: '-0.000003', timestamp: 0},
+        ];
+        expect(roundTrip(snapshots)).to.deep.equal(normalize(snapshots));
+    });
+
+    it('codes an unchanged quote in one byte per field', function () {
+        var snapshots = [];
+        for (var i = 0; i < 100; i++) {
+            snapshots.push({ask: '9.37', bid: '9.36', timestamp: 1699540800 + i});
+        }
+
+        var first = addon.JsTestEncodeSnapshotBlock(snapshots.slice(0, 1));
+        var block = addon.JsTestEncodeSnapshotBlock(snapshots);
+        expect(block.length).to.equal(first.length + 99 * 3);
+    });
+
+    it('throws on a truncated block', function () {
+        var snapshots = getSnapshots(100, 7);
+        var block = addon.JsTestEncodeSnapshotBlock(snapshots);
+        var quantum = addon.JsTestGetPriceQuantum(snapshots);
+
+        var truncated = block.subarray(0, block.length - 1);
+        expect(() =>
+            addon.JsTestDecodeSnapshotBlock(truncated, quantum, snapshots.length)
+        ).to.throw(/Corrupt snapshot block at snapshot 99 of 100/);
+
+        expect(() =>
+            addon.JsTestDecodeSnapshotBlock(block, quantum, snapshots.length + 1)
+        ).to.throw(/Corrupt snapshot block/);
+
+        var empty = Buffer.alloc(0);
+        expect(() => addon.JsTestDecodeSnapshotBlock(empty, quantum, 1)).to.throw(
+            /Corrupt snapshot block/
+        );
+    });
+
+    it('throws on a varint longer than 64 bits', function () {
+        var corrupt = Buffer.alloc(40, 0xff);
+        expect(() => addon.JsTestDecodeSnapshotBlock(corrupt, '0.01', 1)).to.throw(
+            /Corrupt snapshot block at snapshot 0 of 1/
+        );
+
+        var corruptTail = Buffer.alloc(11, 0xff);
+        expect(() => addon.JsTestDecodeSnapshotBlock(corruptTail, '0.01', 1)).to.throw(
+            /Corrupt snapshot block/
+        );
+    });
+});